@@ -0,0 +1,332 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "VenceJohnathan3000.h"
+#include "BoopGame.h"
+#include "BoopMoveGen.h"
+#include "BoopEvalBatch.h"
+
+// Microbenchmarks de las rutas calientes de las reglas. Cada prueba recorre
+// un corpus de tableros de medio juego generados con partidas al azar y
+// reporta nanosegundos por operación, asignaciones por operación y
+// operaciones por segundo.
+//
+// Uso: BoopBench [--tiempo MS] [--corpus N] [--semilla S]
+//                [--guardar ARCHIVO] [--comparar ARCHIVO]
+// --guardar escribe los resultados como línea base y --comparar muestra la
+// diferencia contra una línea base guardada antes.
+
+// Contador de asignaciones: todo new del programa pasa por aquí. Las
+// funciones no se expanden en línea para que GCC no confunda el malloc
+// interno con un new al liberar
+static std::atomic<uint64_t> allocationCount{0};
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// Evita que el compilador descarte el trabajo medido
+static volatile uint64_t benchSink = 0;
+
+const int MAX_PLAYOUT_PLIES = 200;
+
+struct BenchResult {
+    string name;
+    double nsPerOp = 0;
+    double allocsPerOp = 0;
+    double opsPerSec = 0;
+};
+
+// Tablero de medio juego con una jugada legal elegida para él
+struct CorpusEntry {
+    Boop game;
+    Move move;
+};
+
+// Genera el corpus jugando al azar entre 8 y 30 jugadas; las partidas que
+// terminan antes se descartan
+vector<CorpusEntry> buildCorpus(int size, uint64_t seed) {
+    vector<CorpusEntry> corpus;
+    corpus.reserve(size);
+    mt19937_64 rng(seed);
+    NullEventSink events;
+    MoveList moves;
+
+    while (static_cast<int>(corpus.size()) < size) {
+        CorpusEntry entry;
+        int plies = 8 + static_cast<int>(rng() % 23);
+        for (int i = 0; i < plies && !entry.game.gameOver; i++) {
+            generateMoves(entry.game, moves);
+            if (moves.empty()) {
+                break;
+            }
+            Move move = moves[rng() % moves.size()];
+            entry.game.placePiece(move.row(), move.col(), move.type, events);
+        }
+
+        generateMoves(entry.game, moves);
+        if (entry.game.gameOver || moves.empty()) {
+            continue;
+        }
+        entry.move = moves[rng() % moves.size()];
+        corpus.push_back(entry);
+    }
+    return corpus;
+}
+
+// Ejecuta body(i) en lotes cada vez más grandes hasta llenar el tiempo pedido
+template <class Body>
+BenchResult runBenchmark(const string& name, double minSeconds, Body body) {
+    using Clock = chrono::steady_clock;
+    int64_t batch = 16;
+    int64_t ops = 0;
+    uint64_t allocations = 0;
+    double seconds = 0;
+    uint64_t checksum = 0;
+
+    // Una pasada de calentamiento que no se cuenta
+    for (int64_t i = 0; i < batch; i++) {
+        checksum += body(i);
+    }
+
+    while (seconds < minSeconds) {
+        uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        auto start = Clock::now();
+        for (int64_t i = 0; i < batch; i++) {
+            checksum += body(ops + i);
+        }
+        seconds += chrono::duration<double>(Clock::now() - start).count();
+        allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        ops += batch;
+        if (batch < (int64_t(1) << 24)) {
+            batch *= 2;
+        }
+    }
+    benchSink = benchSink + checksum;
+
+    BenchResult result;
+    result.name = name;
+    result.nsPerOp = seconds * 1e9 / ops;
+    result.allocsPerOp = static_cast<double>(allocations) / ops;
+    result.opsPerSec = ops / seconds;
+    return result;
+}
+
+vector<BenchResult> runAll(vector<CorpusEntry>& corpus, double minSeconds, uint64_t seed) {
+    vector<BenchResult> results;
+    const int64_t size = static_cast<int64_t>(corpus.size());
+    NullEventSink events;
+    Boop scratch;
+
+    results.push_back(runBenchmark("Board::boopPieces", minSeconds, [&](int64_t i) {
+        const CorpusEntry& entry = corpus[i % size];
+        Board board = entry.game.board;
+        Move move = entry.move;
+        board.placePiece(Piece(entry.game.currentPlayer->index, move.type), move.row(), move.col());
+        return static_cast<uint64_t>(board.boopPieces(move.row(), move.col(), events).size()) + board.bits.occupied();
+    }));
+
+    results.push_back(runBenchmark("Board::findLinesOfThree", minSeconds, [&](int64_t i) {
+        CorpusEntry& entry = corpus[i % size];
+        return static_cast<uint64_t>(entry.game.board.findLinesOfThree(entry.game.currentPlayer).size());
+    }));
+
+    results.push_back(runBenchmark("Boop::placePiece", minSeconds, [&](int64_t i) {
+        const CorpusEntry& entry = corpus[i % size];
+        scratch = entry.game;
+        scratch.placePiece(entry.move.row(), entry.move.col(), entry.move.type, events);
+        return scratch.keyHistory.back();
+    }));
+
+    results.push_back(runBenchmark("Boop::checkAndPromoteGatitos+checkVictory", minSeconds, [&](int64_t i) {
+        scratch = corpus[i % size].game;
+        scratch.checkAndPromoteGatitos(events);
+        scratch.checkVictory(events);
+        return static_cast<uint64_t>(scratch.player1.gatos_disponibles + scratch.gameOver);
+    }));
+
+    results.push_back(runBenchmark("IsCenterAvailible", minSeconds, [&](int64_t i) {
+        return static_cast<uint64_t>(IsCenterAvailible(corpus[i % size].game.board).size());
+    }));
+
+    results.push_back(runBenchmark("CanPromote", minSeconds, [&](int64_t i) {
+        const CorpusEntry& entry = corpus[i % size];
+        return static_cast<uint64_t>(CanPromote(entry.game.board, entry.game.currentPlayer, PieceType::GATITO).has_value());
+    }));
+
+    // Evaluación de todo el corpus: una posición a la vez y por lotes con
+    // cada núcleo que soporte el procesador
+    EvalBatch batch;
+    for (const CorpusEntry& entry : corpus) {
+        batch.add(entry.game.position());
+    }
+    // Una sola Position a la que se copian los tableros: Position es grande
+    // por su pila de deshacer y un arreglo de ellas mediría fallos de caché
+    unique_ptr<Position> scratchPos(new Position());
+    vector<int> scores(corpus.size());
+    const string corpusLabel = " x" + to_string(size);
+
+    results.push_back(runBenchmark("evaluate" + corpusLabel, minSeconds, [&](int64_t) {
+        uint64_t total = 0;
+        for (int j = 0; j < batch.size(); j++) {
+            for (int p = 0; p < NUM_PLAYERS; p++) {
+                for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+                    scratchPos->board.pieces[p][t] = batch.pieces[p][t][j];
+                }
+                scratchPos->gatos_disponibles[p] = batch.gatosInSupply[p][j];
+            }
+            scratchPos->sideToMove = batch.sideToMove[j];
+            total += static_cast<uint64_t>(evaluate(*scratchPos));
+        }
+        return total;
+    }));
+
+    for (EvalKernel kernel : {EvalKernel::SCALAR, EvalKernel::SSE4, EvalKernel::AVX2}) {
+        if (kernel > bestEvalKernel()) {
+            continue;
+        }
+        results.push_back(runBenchmark(string("EvalBatch ") + evalKernelName(kernel) + corpusLabel, minSeconds,
+                                       [&](int64_t) {
+                                           batch.evaluate(scores.data(), kernel);
+                                           return static_cast<uint64_t>(scores[0]);
+                                       }));
+    }
+
+    mt19937_64 rng(seed);
+    MoveList moves;
+    results.push_back(runBenchmark("partida aleatoria (Boop)", minSeconds, [&](int64_t) {
+        Boop game;
+        int plies = 0;
+        while (!game.gameOver && plies < MAX_PLAYOUT_PLIES) {
+            generateMoves(game, moves);
+            if (moves.empty()) {
+                break;
+            }
+            Move move = moves[rng() % moves.size()];
+            game.placePiece(move.row(), move.col(), move.type, events);
+            plies++;
+        }
+        return static_cast<uint64_t>(plies);
+    }));
+
+    return results;
+}
+
+void saveBaseline(const string& path, const vector<BenchResult>& results) {
+    ofstream out(path);
+    for (const BenchResult& result : results) {
+        out << result.name << '\t' << result.nsPerOp << '\t' << result.allocsPerOp << '\n';
+    }
+}
+
+// Lee una línea base: nombre, ns/op y asignaciones/op separados por tabuladores
+bool loadBaseline(const string& path, map<string, BenchResult>& baseline) {
+    ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    string line;
+    while (getline(in, line)) {
+        size_t first = line.find('\t');
+        size_t second = line.find('\t', first + 1);
+        if (first == string::npos || second == string::npos) {
+            continue;
+        }
+        BenchResult result;
+        result.name = line.substr(0, first);
+        result.nsPerOp = atof(line.c_str() + first + 1);
+        result.allocsPerOp = atof(line.c_str() + second + 1);
+        baseline[result.name] = result;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    double minSeconds = 0.5;
+    int corpusSize = 256;
+    uint64_t seed = 1;
+    string savePath;
+    string comparePath;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--tiempo") == 0 && hasValue) {
+            minSeconds = atof(argv[++i]) / 1000.0;
+        } else if (strcmp(argv[i], "--corpus") == 0 && hasValue) {
+            corpusSize = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--semilla") == 0 && hasValue) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--guardar") == 0 && hasValue) {
+            savePath = argv[++i];
+        } else if (strcmp(argv[i], "--comparar") == 0 && hasValue) {
+            comparePath = argv[++i];
+        } else {
+            cerr << "Opción desconocida: " << argv[i] << endl;
+            return 1;
+        }
+    }
+    if (corpusSize < 1) {
+        corpusSize = 1;
+    }
+
+    map<string, BenchResult> baseline;
+    if (!comparePath.empty() && !loadBaseline(comparePath, baseline)) {
+        cerr << "No se pudo leer la línea base: " << comparePath << endl;
+        return 1;
+    }
+
+    vector<CorpusEntry> corpus = buildCorpus(corpusSize, seed);
+    vector<BenchResult> results = runAll(corpus, minSeconds, seed);
+
+    cout << "Corpus: " << corpus.size() << " tableros (semilla " << seed << ")" << endl;
+    cout << left << setw(44) << "prueba" << right << setw(12) << "ns/op" << setw(12) << "asig/op"
+         << setw(16) << "ops/s";
+    if (!baseline.empty()) {
+        cout << setw(12) << "base ns" << setw(10) << "cambio";
+    }
+    cout << endl;
+
+    cout << fixed;
+    for (const BenchResult& result : results) {
+        cout << left << setw(44) << result.name << right << setprecision(1) << setw(12) << result.nsPerOp
+             << setprecision(2) << setw(12) << result.allocsPerOp << setprecision(0) << setw(16)
+             << result.opsPerSec;
+        auto it = baseline.find(result.name);
+        if (it != baseline.end() && it->second.nsPerOp > 0) {
+            double change = 100.0 * (result.nsPerOp - it->second.nsPerOp) / it->second.nsPerOp;
+            cout << setprecision(1) << setw(12) << it->second.nsPerOp << setw(9) << showpos << change
+                 << "%" << noshowpos;
+        }
+        cout << endl;
+    }
+
+    if (!savePath.empty()) {
+        saveBaseline(savePath, results);
+        cout << "Línea base guardada en " << savePath << endl;
+    }
+    return 0;
+}
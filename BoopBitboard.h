@@ -0,0 +1,376 @@
+#ifndef BOOPBITBOARD_H
+#define BOOPBITBOARD_H
+
+#include <cstdint>
+
+// Representación compacta del tablero de Boop.
+// Cada casilla (row, col) se numera como sq = row * N + col, así que
+// cualquier tablero de hasta 8x8 cabe en una sola palabra de 64 bits.
+// El tamaño es un parámetro de plantilla: las tablas de líneas, vecinos y
+// centro de cada tamaño se generan en compilación y los bucles tienen
+// límites constantes. Los nombres sin plantilla (LINES, NEIGHBORS, BitBoard,
+// ...) son los del tablero estándar de 6x6.
+
+typedef uint64_t Bitboard;
+
+const int BOARD_SIZE = 6;
+const int NUM_SQUARES = BOARD_SIZE * BOARD_SIZE;
+const int MAX_BOARD_SIZE = 8;
+const int MAX_SQUARES = MAX_BOARD_SIZE * MAX_BOARD_SIZE;
+const int NUM_PLAYERS = 2;
+const int NUM_PIECE_TYPES = 2;
+
+// Enumeración para tipos de pieza
+enum class PieceType {
+    GATITO = 1,
+    GATO = 2
+};
+
+// Índice 0/1 de un tipo de pieza dentro de las máscaras
+constexpr int typeIndex(PieceType type) {
+    return static_cast<int>(type) - 1;
+}
+
+constexpr PieceType typeFromIndex(int index) {
+    return static_cast<PieceType>(index + 1);
+}
+
+constexpr int squareOf(int row, int col) {
+    return row * BOARD_SIZE + col;
+}
+
+constexpr int rowOf(int sq) {
+    return sq / BOARD_SIZE;
+}
+
+constexpr int colOf(int sq) {
+    return sq % BOARD_SIZE;
+}
+
+constexpr Bitboard squareBit(int sq) {
+    return Bitboard(1) << sq;
+}
+
+inline int popCount(Bitboard b) {
+    return __builtin_popcountll(b);
+}
+
+// Extrae y devuelve la casilla menos significativa de la máscara
+inline int popLsb(Bitboard& b) {
+    int sq = __builtin_ctzll(b);
+    b &= b - 1;
+    return sq;
+}
+
+const int LINE_LENGTH = 3;
+const int NUM_DIRECTIONS = 8;
+const uint8_t OFF_BOARD = 0xFF;
+
+// Centro del tablero: el bloque de 2x2 en tableros pares, la casilla
+// central en los impares
+constexpr Bitboard centerMask(int size) {
+    Bitboard mask = 0;
+    for (int row = (size - 1) / 2; row <= size / 2; row++) {
+        for (int col = (size - 1) / 2; col <= size / 2; col++) {
+            mask |= squareBit(row * size + col);
+        }
+    }
+    return mask;
+}
+
+// Medidas y conversiones de un tablero de NxN
+template <int N>
+struct BoardGeometry {
+    static_assert(N >= LINE_LENGTH && N <= MAX_BOARD_SIZE, "El tablero debe caber en 64 bits");
+
+    static constexpr int SIZE = N;
+    static constexpr int NUM_SQUARES = N * N;
+    // Ventanas de tres: horizontales y verticales, más ambas diagonales
+    static constexpr int NUM_LINES = 2 * N * (N - 2) + 2 * (N - 2) * (N - 2);
+    static constexpr Bitboard ALL_SQUARES = NUM_SQUARES == 64 ? ~Bitboard(0) : (Bitboard(1) << NUM_SQUARES) - 1;
+    static constexpr Bitboard CENTER = centerMask(N);
+
+    static constexpr int squareOf(int row, int col) { return row * N + col; }
+    static constexpr int rowOf(int sq) { return sq / N; }
+    static constexpr int colOf(int sq) { return sq % N; }
+};
+
+const int NUM_LINES = BoardGeometry<BOARD_SIZE>::NUM_LINES;
+const Bitboard ALL_SQUARES = BoardGeometry<BOARD_SIZE>::ALL_SQUARES;
+
+// Clase BitBoard: una máscara de 64 bits por (jugador, tipo de pieza)
+template <int N>
+struct BasicBitBoard {
+    Bitboard pieces[NUM_PLAYERS][NUM_PIECE_TYPES] = {{0, 0}, {0, 0}};
+
+    Bitboard occupied() const {
+        return pieces[0][0] | pieces[0][1] | pieces[1][0] | pieces[1][1];
+    }
+
+    Bitboard empty() const {
+        return ~occupied() & BoardGeometry<N>::ALL_SQUARES;
+    }
+
+    Bitboard ofPlayer(int player) const {
+        return pieces[player][0] | pieces[player][1];
+    }
+
+    Bitboard ofType(int type) const {
+        return pieces[0][type] | pieces[1][type];
+    }
+
+    bool isEmpty(int sq) const {
+        return (occupied() & squareBit(sq)) == 0;
+    }
+
+    void set(int player, int type, int sq) {
+        pieces[player][type] |= squareBit(sq);
+    }
+
+    void clear(int player, int type, int sq) {
+        pieces[player][type] &= ~squareBit(sq);
+    }
+
+    // Retorna el dueño (0/1) de la casilla, o -1 si está vacía
+    int ownerAt(int sq) const {
+        Bitboard bit = squareBit(sq);
+        if (ofPlayer(0) & bit) return 0;
+        if (ofPlayer(1) & bit) return 1;
+        return -1;
+    }
+
+    // Retorna el tipo (0/1) de la casilla, o -1 si está vacía
+    int typeAt(int sq) const {
+        Bitboard bit = squareBit(sq);
+        if (ofType(0) & bit) return 0;
+        if (ofType(1) & bit) return 1;
+        return -1;
+    }
+};
+
+using BitBoard = BasicBitBoard<BOARD_SIZE>;
+
+// Tabla de líneas de tres: todas las ventanas de 3 casillas del tablero
+// (horizontales, verticales y ambas diagonales), generada en compilación.
+// El orden es el mismo que recorría findLinesOfThree: por casilla inicial
+// en orden de fila y columna, y luego por dirección.
+template <int N>
+struct LineTable {
+    Bitboard mask[BoardGeometry<N>::NUM_LINES];
+    uint8_t squares[BoardGeometry<N>::NUM_LINES][LINE_LENGTH];
+};
+
+template <int N>
+constexpr LineTable<N> makeLineTable() {
+    LineTable<N> table{};
+    const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    int n = 0;
+
+    for (int row = 0; row < N; row++) {
+        for (int col = 0; col < N; col++) {
+            for (int d = 0; d < 4; d++) {
+                int endRow = row + 2 * directions[d][0];
+                int endCol = col + 2 * directions[d][1];
+                if (endRow < 0 || endRow >= N || endCol < 0 || endCol >= N) {
+                    continue;
+                }
+                for (int i = 0; i < LINE_LENGTH; i++) {
+                    int sq = (row + i * directions[d][0]) * N + col + i * directions[d][1];
+                    table.squares[n][i] = static_cast<uint8_t>(sq);
+                    table.mask[n] |= Bitboard(1) << sq;
+                }
+                n++;
+            }
+        }
+    }
+    return table;
+}
+
+template <int N>
+inline constexpr LineTable<N> LINE_TABLE = makeLineTable<N>();
+
+inline constexpr const LineTable<BOARD_SIZE>& LINES = LINE_TABLE<BOARD_SIZE>;
+
+// Retorna true si alguna línea de tres está completa dentro de la máscara
+template <int N = BOARD_SIZE>
+inline bool hasLineOfThree(Bitboard mask) {
+    for (int i = 0; i < BoardGeometry<N>::NUM_LINES; i++) {
+        if ((mask & LINE_TABLE<N>.mask[i]) == LINE_TABLE<N>.mask[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Casillas de amenaza por (jugador, tipo): casillas vacías donde una pieza
+// de ese tipo completaría una línea de tres
+struct ThreatMap {
+    Bitboard squares[NUM_PLAYERS][NUM_PIECE_TYPES];
+};
+
+// Calcula en una sola pasada por las líneas las amenazas de ambos jugadores
+template <int N>
+inline void findThreats(const BasicBitBoard<N>& board, ThreatMap& threats) {
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            threats.squares[p][t] = 0;
+        }
+    }
+
+    Bitboard empty = board.empty();
+    for (int i = 0; i < BoardGeometry<N>::NUM_LINES; i++) {
+        Bitboard line = LINE_TABLE<N>.mask[i];
+        Bitboard hole = line & empty;
+        // Solo interesan las líneas con una única casilla vacía
+        if (!hole || (hole & (hole - 1)) != 0) {
+            continue;
+        }
+        for (int p = 0; p < NUM_PLAYERS; p++) {
+            for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+                if (((board.pieces[p][t] | hole) & line) == line) {
+                    threats.squares[p][t] |= hole;
+                }
+            }
+        }
+    }
+}
+
+// Líneas completas por (jugador, tipo), como índices dentro de la tabla de líneas
+template <int N>
+struct BasicLineHits {
+    int count[NUM_PLAYERS][NUM_PIECE_TYPES];
+    uint8_t lines[NUM_PLAYERS][NUM_PIECE_TYPES][BoardGeometry<N>::NUM_LINES];
+};
+
+using LineHits = BasicLineHits<BOARD_SIZE>;
+
+// Busca en una sola pasada todas las líneas de tres de ambos jugadores
+template <int N>
+inline void findAllLines(const BasicBitBoard<N>& board, BasicLineHits<N>& hits) {
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            hits.count[p][t] = 0;
+        }
+    }
+
+    Bitboard occupied = board.occupied();
+    for (int i = 0; i < BoardGeometry<N>::NUM_LINES; i++) {
+        Bitboard line = LINE_TABLE<N>.mask[i];
+        if ((occupied & line) != line) {
+            continue;
+        }
+        for (int p = 0; p < NUM_PLAYERS; p++) {
+            for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+                if ((board.pieces[p][t] & line) == line) {
+                    hits.lines[p][t][hits.count[p][t]++] = static_cast<uint8_t>(i);
+                }
+            }
+        }
+    }
+}
+
+// Tablas de vecinos: para cada casilla, sus 8 vecinas y la casilla a la que
+// un boop empujaría a cada vecina. OFF_BOARD marca posiciones fuera del tablero.
+template <int N>
+struct NeighborTable {
+    uint8_t neighbor[N * N][NUM_DIRECTIONS];
+    uint8_t push[N * N][NUM_DIRECTIONS];
+    Bitboard adjacent[N * N];
+};
+
+template <int N>
+constexpr NeighborTable<N> makeNeighborTable() {
+    NeighborTable<N> table{};
+    const int directions[NUM_DIRECTIONS][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+
+    for (int sq = 0; sq < N * N; sq++) {
+        int row = sq / N;
+        int col = sq % N;
+        for (int d = 0; d < NUM_DIRECTIONS; d++) {
+            int adjRow = row + directions[d][0];
+            int adjCol = col + directions[d][1];
+            int newRow = adjRow + directions[d][0];
+            int newCol = adjCol + directions[d][1];
+            bool adjValid = adjRow >= 0 && adjRow < N && adjCol >= 0 && adjCol < N;
+            bool newValid = newRow >= 0 && newRow < N && newCol >= 0 && newCol < N;
+
+            table.neighbor[sq][d] = adjValid ? static_cast<uint8_t>(adjRow * N + adjCol) : OFF_BOARD;
+            table.push[sq][d] = newValid ? static_cast<uint8_t>(newRow * N + newCol) : OFF_BOARD;
+            if (adjValid) {
+                table.adjacent[sq] |= Bitboard(1) << (adjRow * N + adjCol);
+            }
+        }
+    }
+    return table;
+}
+
+template <int N>
+inline constexpr NeighborTable<N> NEIGHBOR_TABLE = makeNeighborTable<N>();
+
+inline constexpr const NeighborTable<BOARD_SIZE>& NEIGHBORS = NEIGHBOR_TABLE<BOARD_SIZE>;
+
+// Los tamaños de las variantes con las que se experimenta (4x4, 5x5, 6x6 y
+// 8x8) se comprueban aquí para que sus tablas se generen siempre
+static_assert(LINE_TABLE<4>.mask[BoardGeometry<4>::NUM_LINES - 1] == (squareBit(13) | squareBit(14) | squareBit(15)),
+              "tabla de líneas de 4x4");
+static_assert(LINE_TABLE<5>.mask[BoardGeometry<5>::NUM_LINES - 1] == (squareBit(22) | squareBit(23) | squareBit(24)),
+              "tabla de líneas de 5x5");
+static_assert(LINE_TABLE<8>.mask[BoardGeometry<8>::NUM_LINES - 1] == (squareBit(61) | squareBit(62) | squareBit(63)),
+              "tabla de líneas de 8x8");
+static_assert(BoardGeometry<BOARD_SIZE>::CENTER ==
+                  (squareBit(squareOf(2, 2)) | squareBit(squareOf(2, 3)) | squareBit(squareOf(3, 2)) |
+                   squareBit(squareOf(3, 3))),
+              "centro de 6x6");
+static_assert(BoardGeometry<5>::CENTER == squareBit(12), "centro de 5x5");
+static_assert(NEIGHBOR_TABLE<8>.push[0][7] == 18 && NEIGHBOR_TABLE<4>.push[0][7] == 10, "vecinos");
+
+// Resultado de un boop: gatitos desplazados y gatitos expulsados del tablero.
+// Como mucho hay una pieza afectada por dirección.
+struct BoopResult {
+    int pushedCount = 0;
+    uint8_t pushedFrom[NUM_DIRECTIONS];
+    uint8_t pushedTo[NUM_DIRECTIONS];
+    int outCount = 0;
+    uint8_t outSquare[NUM_DIRECTIONS];
+    uint8_t outOwner[NUM_DIRECTIONS];
+};
+
+// Empuja los gatitos vecinos a la casilla sq. Los gatos no pueden ser empujados;
+// un gatito se mueve si su destino está vacío y sale del tablero si el destino
+// está fuera. Los destinos están a distancia 2, así que los empujes no se afectan
+// entre sí y basta con la ocupación inicial.
+template <int N>
+inline void boopAround(BasicBitBoard<N>& board, int sq, BoopResult& result) {
+    const NeighborTable<N>& neighbors = NEIGHBOR_TABLE<N>;
+    result.pushedCount = 0;
+    result.outCount = 0;
+
+    Bitboard boopable = board.ofType(0) & neighbors.adjacent[sq];
+    if (!boopable) {
+        return;
+    }
+
+    Bitboard occupied = board.occupied();
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        int adj = neighbors.neighbor[sq][d];
+        if (adj == OFF_BOARD || !(boopable & squareBit(adj))) {
+            continue;
+        }
+
+        int owner = (board.pieces[1][0] & squareBit(adj)) ? 1 : 0;
+        int dest = neighbors.push[sq][d];
+        if (dest == OFF_BOARD) {
+            board.pieces[owner][0] &= ~squareBit(adj);
+            result.outSquare[result.outCount] = static_cast<uint8_t>(adj);
+            result.outOwner[result.outCount] = static_cast<uint8_t>(owner);
+            result.outCount++;
+        } else if (!(occupied & squareBit(dest))) {
+            board.pieces[owner][0] ^= squareBit(adj) | squareBit(dest);
+            result.pushedFrom[result.pushedCount] = static_cast<uint8_t>(adj);
+            result.pushedTo[result.pushedCount] = static_cast<uint8_t>(dest);
+            result.pushedCount++;
+        }
+    }
+}
+
+#endif // BOOPBITBOARD_H
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BoopBook.h"
+#include "BoopGame.h"
+#include "BoopRecord.h"
+
+// Construye y consulta libros de aperturas (BoopBook.h).
+//
+// Uso: BoopBook --construir LIBRO --registros ARCHIVO [--registros ARCHIVO ...]
+//               [--profundidad N] [--minimo N] [--evaluadas]
+//      BoopBook --consultar LIBRO [--jugadas "f,c,t f,c,t ..."]
+//               [--peso jugadas|resultados|evaluacion] [--minimo N]
+// --construir suma las primeras --profundidad jugadas (12 por defecto) de
+// cada partida de los archivos de registros de BoopSelfPlay --guardar y
+// escribe las jugadas con al menos --minimo partidas. Con --evaluadas solo se
+// suman las jugadas que traen la evaluación del motor, es decir, las de
+// búsqueda; así las aperturas al azar de --apertura no entran al libro.
+// --consultar muestra las jugadas del libro para la posición tras --jugadas
+// y la que elegiría el motor con el --peso dado.
+
+struct BookToolOptions {
+    string bookPath;
+    bool build = false;
+    vector<string> recordPaths;
+    int maxPly = 12;
+    uint32_t minGames = 1;
+    bool onlyScored = false;
+    string moves;
+    BookWeighting weighting = BookWeighting::RESULTS;
+};
+
+// Aplica una lista de jugadas "fila,columna,tipo" separadas por espacios y
+// cuenta en plies las que aplicó
+bool playMoves(Position& pos, const string& text, int& plies) {
+    stringstream ss(text);
+    string token;
+    while (ss >> token) {
+        int row = 0;
+        int col = 0;
+        char type = 0;
+        if (sscanf(token.c_str(), "%d,%d,%c", &row, &col, &type) != 3 || (type != 'g' && type != 'G') || row < 0 ||
+            row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE) {
+            cerr << "Jugada inválida: " << token << endl;
+            return false;
+        }
+        Move move(squareOf(row, col), type == 'g' ? PieceType::GATITO : PieceType::GATO);
+        if (!pos.isLegal(move)) {
+            cerr << "Jugada ilegal: " << token << endl;
+            return false;
+        }
+        pos.makeMove(move);
+        pos.clearHistory();
+        plies++;
+    }
+    return true;
+}
+
+int buildBook(const BookToolOptions& options) {
+    OpeningBookBuilder builder;
+    builder.maxPly = options.maxPly;
+    builder.onlyScored = options.onlyScored;
+    int64_t skipped = 0;
+    for (const string& path : options.recordPaths) {
+        GameRecordFile records;
+        if (!records.open(path)) {
+            cerr << "No se pudo leer el archivo de registros: " << path << endl;
+            return 1;
+        }
+        for (GameRecordView record : records) {
+            if (!builder.addRecord(record)) {
+                skipped++;
+            }
+        }
+    }
+    if (!builder.write(options.bookPath, options.minGames)) {
+        cerr << "No se pudo escribir el libro: " << options.bookPath << endl;
+        return 1;
+    }
+
+    OpeningBook book;
+    if (!book.open(options.bookPath)) {
+        cerr << "No se pudo abrir el libro escrito: " << options.bookPath << endl;
+        return 1;
+    }
+    cout << "Partidas: " << builder.games() << " (" << skipped << " descartadas o incompletas)" << endl;
+    cout << "Jugadas en el libro: " << book.header().entries << " de " << builder.size() << " sumadas" << endl;
+    return 0;
+}
+
+int queryBook(const BookToolOptions& options) {
+    OpeningBook book;
+    if (!book.open(options.bookPath)) {
+        cerr << "No se pudo abrir el libro: " << options.bookPath << endl;
+        return 1;
+    }
+    book.options.minGames = options.minGames;
+    book.options.weighting = options.weighting;
+
+    unique_ptr<Position> pos(new Position());
+    int ply = 0;
+    if (!playMoves(*pos, options.moves, ply)) {
+        return 1;
+    }
+
+    vector<BookMove> moves;
+    book.probe(*pos, moves);
+    cout << "Libro de " << book.header().games << " partidas, " << book.header().entries << " jugadas" << endl;
+    if (moves.empty()) {
+        cout << "La posición no está en el libro" << endl;
+        return 0;
+    }
+    sort(moves.begin(), moves.end(),
+         [](const BookMove& a, const BookMove& b) { return a.entry->games > b.entry->games; });
+    for (const BookMove& bookMove : moves) {
+        const BookEntry& entry = *bookMove.entry;
+        cout << "  " << bookMove.move.row() << "," << bookMove.move.col() << ","
+             << (bookMove.move.type == PieceType::GATITO ? "g" : "G") << ": " << entry.games << " partidas, "
+             << entry.wins << " ganadas, " << entry.losses << " perdidas, rendimiento " << fixed << setprecision(3)
+             << bookMove.performance();
+        if (entry.flags & BOOK_HAS_SCORE) {
+            cout << ", evaluación " << entry.score;
+        }
+        cout << endl;
+    }
+
+    mt19937_64 rng(0x426F6F70);
+    Move choice;
+    if (book.choose(*pos, ply, rng, choice)) {
+        cout << "Elegida: " << choice.row() << "," << choice.col() << "," << (choice.type == PieceType::GATITO ? "g" : "G")
+             << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    BookToolOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--construir") == 0 && hasValue) {
+            options.bookPath = argv[++i];
+            options.build = true;
+        } else if (strcmp(argv[i], "--consultar") == 0 && hasValue) {
+            options.bookPath = argv[++i];
+            options.build = false;
+        } else if (strcmp(argv[i], "--registros") == 0 && hasValue) {
+            options.recordPaths.push_back(argv[++i]);
+        } else if (strcmp(argv[i], "--profundidad") == 0 && hasValue) {
+            options.maxPly = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--minimo") == 0 && hasValue) {
+            options.minGames = static_cast<uint32_t>(max(1, atoi(argv[++i])));
+        } else if (strcmp(argv[i], "--evaluadas") == 0) {
+            options.onlyScored = true;
+        } else if (strcmp(argv[i], "--jugadas") == 0 && hasValue) {
+            options.moves = argv[++i];
+        } else if (strcmp(argv[i], "--peso") == 0 && hasValue) {
+            string weight = argv[++i];
+            if (weight == "jugadas") {
+                options.weighting = BookWeighting::PLAYED;
+            } else if (weight == "resultados") {
+                options.weighting = BookWeighting::RESULTS;
+            } else if (weight == "evaluacion") {
+                options.weighting = BookWeighting::SCORE;
+            } else {
+                cerr << "Peso desconocido: " << weight << " (jugadas, resultados o evaluacion)" << endl;
+                return 1;
+            }
+        } else {
+            cerr << "Opción desconocida: " << argv[i] << endl;
+            return 1;
+        }
+    }
+    if (options.bookPath.empty()) {
+        cerr << "Falta --construir LIBRO o --consultar LIBRO" << endl;
+        return 1;
+    }
+    if (options.build && options.recordPaths.empty()) {
+        cerr << "Falta --registros ARCHIVO" << endl;
+        return 1;
+    }
+
+    return options.build ? buildBook(options) : queryBook(options);
+}
@@ -0,0 +1,360 @@
+#ifndef BOOPBOOK_H
+#define BOOPBOOK_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BoopGame.h"
+#include "BoopRecord.h"
+#include "BoopSymmetry.h"
+
+// Libro de aperturas. El archivo es una cabecera de 32 bytes y un arreglo de
+// entradas de 24 bytes ordenado por (clave, jugada): cada entrada guarda las
+// estadísticas de una jugada desde una posición. Las posiciones se guardan por
+// su clave canónica (BoopSymmetry.h) y las jugadas en esa orientación, así que
+// las 8 orientaciones de una apertura suman en las mismas entradas, y en una
+// posición simétrica las jugadas equivalentes son una sola entrada.
+// El lector proyecta el archivo con mmap y busca con búsqueda binaria: abrir
+// el libro no lee ni interpreta nada.
+//
+// El constructor suma las primeras jugadas de partidas guardadas con
+// BoopRecord.h: partidas de autojuego, y de ellas las jugadas de búsqueda
+// traen la evaluación del motor. Como la clave canónica no distingue el orden
+// de graduación (ver BoopSymmetry.h), cada jugada del libro se comprueba
+// legal antes de usarla.
+
+const char BOOK_MAGIC[8] = {'B', 'O', 'O', 'P', 'B', 'O', 'K', '1'};
+const uint32_t BOOK_VERSION = 1;
+const uint8_t BOOK_HAS_SCORE = 1;
+
+struct BookFileHeader {
+    char magic[8];
+    uint32_t version;
+    // Jugadas de cada partida que se sumaron al construir el libro
+    uint32_t maxPly;
+    uint64_t entries;
+    uint64_t games;
+};
+
+struct BookEntry {
+    uint64_t key;
+    // encodeRecordMove de la jugada en la orientación canónica
+    uint8_t move;
+    uint8_t flags;
+    // Evaluación media del motor para el que mueve, si flags tiene BOOK_HAS_SCORE
+    int16_t score;
+    uint32_t games;
+    // Victorias y derrotas del que hizo la jugada; el resto son tablas o
+    // partidas sin terminar
+    uint32_t wins;
+    uint32_t losses;
+};
+
+static_assert(sizeof(BookFileHeader) == 32, "cabecera de libro de 32 bytes");
+static_assert(sizeof(BookEntry) == 24, "entrada de libro de 24 bytes");
+
+// Cómo se elige entre las jugadas del libro
+enum class BookWeighting {
+    // Al azar, en proporción a las partidas jugadas
+    PLAYED,
+    // Al azar, en proporción a partidas por rendimiento (victoria 1, tablas 1/2)
+    RESULTS,
+    // Siempre la de mejor evaluación media del motor; sin evaluaciones, o con
+    // evaluaciones iguales, la de mejor rendimiento
+    SCORE
+};
+
+struct BookOptions {
+    // No se usa el libro desde esta jugada de la partida; 0 es sin límite
+    int maxPly = 0;
+    // Jugadas con menos partidas se ignoran
+    uint32_t minGames = 1;
+    BookWeighting weighting = BookWeighting::RESULTS;
+};
+
+// Jugada del libro ya llevada a la orientación de la posición consultada
+struct BookMove {
+    Move move;
+    const BookEntry* entry = nullptr;
+
+    // Rendimiento con un empate virtual de cada lado, para que una jugada con
+    // una sola partida ganada no parezca perfecta
+    double performance() const {
+        uint32_t draws = entry->games - entry->wins - entry->losses;
+        return (entry->wins + 0.5 * draws + 1.0) / (entry->games + 2.0);
+    }
+};
+
+// Clave canónica de la posición y claves de sus 8 orientaciones
+inline uint64_t canonicalBookKey(const Position& pos, uint64_t keys[NUM_SYMMETRIES]) {
+    symmetryKeys(pos, keys);
+    return *min_element(keys, keys + NUM_SYMMETRIES);
+}
+
+// Código de la jugada en la orientación canónica. Si varias simetrías llevan
+// la posición a su forma canónica (la inicial, por ejemplo, es simétrica), las
+// jugadas equivalentes se juntan en el código menor
+inline uint8_t canonicalBookMove(const Move& move, uint64_t key, const uint64_t keys[NUM_SYMMETRIES]) {
+    uint8_t best = UINT8_MAX;
+    for (int s = 0; s < NUM_SYMMETRIES; s++) {
+        if (keys[s] == key) {
+            best = min(best, encodeRecordMove(transformMove(move, s)));
+        }
+    }
+    return best;
+}
+
+// Clase OpeningBook: lector sobre mmap
+class OpeningBook {
+public:
+    BookOptions options;
+
+    OpeningBook() = default;
+    ~OpeningBook() { close(); }
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    bool open(const string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+    const BookFileHeader& header() const { return *reinterpret_cast<const BookFileHeader*>(data); }
+
+    // Jugadas legales del libro para la posición, sin aplicar las opciones
+    void probe(const Position& pos, vector<BookMove>& moves) const;
+    // Elige una jugada según las opciones; ply es la jugada de la partida.
+    // False si la posición no está en el libro o ninguna jugada pasa el filtro
+    bool choose(const Position& pos, int ply, mt19937_64& rng, Move& move) const;
+
+private:
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+
+    const BookEntry* entries() const { return reinterpret_cast<const BookEntry*>(data + sizeof(BookFileHeader)); }
+};
+
+inline bool OpeningBook::open(const string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(BookFileHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    const BookFileHeader* header = static_cast<const BookFileHeader*>(mapped);
+    if (memcmp(header->magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 || header->version != BOOK_VERSION ||
+        sizeof(BookFileHeader) + header->entries * sizeof(BookEntry) != static_cast<size_t>(info.st_size)) {
+        munmap(mapped, info.st_size);
+        return false;
+    }
+    data = static_cast<const uint8_t*>(mapped);
+    length = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+inline void OpeningBook::close() {
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), length);
+        data = nullptr;
+        length = 0;
+    }
+}
+
+inline void OpeningBook::probe(const Position& pos, vector<BookMove>& moves) const {
+    moves.clear();
+    if (!data || pos.gameOver) {
+        return;
+    }
+    uint64_t keys[NUM_SYMMETRIES];
+    uint64_t key = canonicalBookKey(pos, keys);
+    const BookEntry* first = entries();
+    const BookEntry* last = first + header().entries;
+    const BookEntry* it =
+        lower_bound(first, last, key, [](const BookEntry& entry, uint64_t key) { return entry.key < key; });
+    for (; it != last && it->key == key; ++it) {
+        // Cualquier simetría que lleve a la forma canónica sirve para volver
+        for (int s = 0; s < NUM_SYMMETRIES; s++) {
+            if (keys[s] != key) {
+                continue;
+            }
+            BookMove bookMove;
+            bookMove.move = transformMove(decodeRecordMove(it->move), inverseSymmetry(s));
+            bookMove.entry = it;
+            if (pos.isLegal(bookMove.move)) {
+                moves.push_back(bookMove);
+                break;
+            }
+        }
+    }
+}
+
+inline bool OpeningBook::choose(const Position& pos, int ply, mt19937_64& rng, Move& move) const {
+    if (options.maxPly > 0 && ply >= options.maxPly) {
+        return false;
+    }
+    vector<BookMove> moves;
+    probe(pos, moves);
+    moves.erase(remove_if(moves.begin(), moves.end(),
+                          [this](const BookMove& bookMove) { return bookMove.entry->games < options.minGames; }),
+                moves.end());
+    if (moves.empty()) {
+        return false;
+    }
+
+    if (options.weighting == BookWeighting::SCORE) {
+        bool scored = any_of(moves.begin(), moves.end(),
+                             [](const BookMove& bookMove) { return bookMove.entry->flags & BOOK_HAS_SCORE; });
+        const BookMove* best = nullptr;
+        for (const BookMove& bookMove : moves) {
+            if (scored && !(bookMove.entry->flags & BOOK_HAS_SCORE)) {
+                continue;
+            }
+            // Con evaluaciones iguales decide el rendimiento
+            if (!best || (scored && bookMove.entry->score != best->entry->score
+                              ? bookMove.entry->score > best->entry->score
+                              : bookMove.performance() > best->performance())) {
+                best = &bookMove;
+            }
+        }
+        move = best->move;
+        return true;
+    }
+
+    vector<double> weights;
+    for (const BookMove& bookMove : moves) {
+        double weight = bookMove.entry->games;
+        if (options.weighting == BookWeighting::RESULTS) {
+            weight *= bookMove.performance();
+        }
+        weights.push_back(weight);
+    }
+    discrete_distribution<size_t> pick(weights.begin(), weights.end());
+    move = moves[pick(rng)].move;
+    return true;
+}
+
+// Clase OpeningBookBuilder: suma partidas y escribe el libro
+class OpeningBookBuilder {
+public:
+    // Jugadas de cada partida que se suman
+    int maxPly = 12;
+    // Solo se suman las jugadas con evaluación del motor (las de búsqueda), no
+    // las de apertura al azar ni las de políticas sin búsqueda
+    bool onlyScored = false;
+
+    OpeningBookBuilder() : pos(new Position()) {}
+
+    // Suma una partida guardada; false si es de otra variante o una jugada es
+    // ilegal (se suma lo reproducido hasta ahí)
+    bool addRecord(const GameRecordView& record);
+    // Escribe las jugadas con al menos minGames partidas
+    bool write(const string& path, uint32_t minGames = 1) const;
+    uint64_t games() const { return gameCount; }
+    size_t size() const { return stats.size(); }
+
+private:
+    struct Stats {
+        uint32_t games = 0;
+        uint32_t wins = 0;
+        uint32_t losses = 0;
+        uint32_t scored = 0;
+        int64_t scoreSum = 0;
+    };
+
+    // Ordenado por (clave canónica, jugada canónica), el orden del archivo
+    map<pair<uint64_t, uint8_t>, Stats> stats;
+    uint64_t gameCount = 0;
+    unique_ptr<Position> pos;
+};
+
+inline bool OpeningBookBuilder::addRecord(const GameRecordView& record) {
+    if (record.header->boardSize != BOARD_SIZE || record.header->supply != INITIAL_GATITOS ||
+        record.header->rules != RULES_STANDARD) {
+        return false;
+    }
+    gameCount++;
+    int plies = min(record.plies(), maxPly);
+    *pos = Position();
+    for (int i = 0; i < plies; i++) {
+        Move move = record.move(i);
+        if (!pos->isLegal(move)) {
+            return false;
+        }
+        int16_t score = record.score(i);
+        if (!onlyScored || score != NO_RECORD_SCORE) {
+            uint64_t keys[NUM_SYMMETRIES];
+            uint64_t key = canonicalBookKey(*pos, keys);
+            Stats& entry = stats[{key, canonicalBookMove(move, key, keys)}];
+            entry.games++;
+            if (record.header->result != RecordResult::UNFINISHED) {
+                bool won = static_cast<int>(record.header->result) == pos->sideToMove;
+                (won ? entry.wins : entry.losses)++;
+            }
+            if (score != NO_RECORD_SCORE) {
+                entry.scored++;
+                entry.scoreSum += score;
+            }
+        }
+        pos->makeMove(move);
+        pos->clearHistory();
+    }
+    return true;
+}
+
+inline bool OpeningBookBuilder::write(const string& path, uint32_t minGames) const {
+    vector<BookEntry> entries;
+    for (const auto& item : stats) {
+        const Stats& entry = item.second;
+        if (entry.games < minGames) {
+            continue;
+        }
+        BookEntry out = {};
+        out.key = item.first.first;
+        out.move = item.first.second;
+        out.games = entry.games;
+        out.wins = entry.wins;
+        out.losses = entry.losses;
+        if (entry.scored > 0) {
+            out.flags |= BOOK_HAS_SCORE;
+            out.score = static_cast<int16_t>(entry.scoreSum / entry.scored);
+        }
+        entries.push_back(out);
+    }
+
+    BookFileHeader header = {};
+    memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.version = BOOK_VERSION;
+    header.maxPly = static_cast<uint32_t>(maxPly);
+    header.entries = entries.size();
+    header.games = gameCount;
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(entries.data(), sizeof(BookEntry), entries.size(), file) == entries.size();
+    return fclose(file) == 0 && ok;
+}
+
+#endif // BOOPBOOK_H
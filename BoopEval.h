@@ -0,0 +1,118 @@
+#ifndef BOOPEVAL_H
+#define BOOPEVAL_H
+
+#include "BoopPosition.h"
+
+// Evaluación estática de una posición, en puntos desde el punto de vista
+// del jugador que mueve.
+
+const int WIN_SCORE = 30000;
+const int MAX_WIN_DISTANCE = MAX_PLY;
+
+// Casillas centrales, las mismas que revisa IsCenterAvailible
+constexpr Bitboard CENTER_SQUARES = squareBit(squareOf(BOARD_SIZE / 2 - 1, BOARD_SIZE / 2 - 1)) |
+                                    squareBit(squareOf(BOARD_SIZE / 2 - 1, BOARD_SIZE / 2)) |
+                                    squareBit(squareOf(BOARD_SIZE / 2, BOARD_SIZE / 2 - 1)) |
+                                    squareBit(squareOf(BOARD_SIZE / 2, BOARD_SIZE / 2));
+
+// Borde del tablero: un gatito aquí puede ser expulsado con un boop
+constexpr Bitboard EDGE_SQUARES = ALL_SQUARES & ~(
+    [] {
+        Bitboard inner = 0;
+        for (int row = 1; row < BOARD_SIZE - 1; row++) {
+            for (int col = 1; col < BOARD_SIZE - 1; col++) {
+                inner |= squareBit(squareOf(row, col));
+            }
+        }
+        return inner;
+    }());
+
+// Pesos de la evaluación
+const int EVAL_GATO_ON_BOARD = 30;
+const int EVAL_GATO_IN_SUPPLY = 25;
+const int EVAL_GATITO_ON_BOARD = 2;
+const int EVAL_CENTER = 5;
+const int EVAL_EDGE_GATITO = -3;
+const int EVAL_GATITO_THREAT = 10;
+const int EVAL_GATO_THREAT = 40;
+
+// Cuenta las líneas con dos piezas del mismo tipo y la tercera casilla vacía
+inline void countThreats(const BitBoard& board, int threats[NUM_PLAYERS][NUM_PIECE_TYPES]) {
+    Bitboard empty = board.empty();
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        threats[p][0] = 0;
+        threats[p][1] = 0;
+    }
+
+    // Con una sola casilla vacía, las otras dos son del mismo jugador y tipo
+    // si esas piezas más el hueco cubren la línea
+    for (int i = 0; i < NUM_LINES; i++) {
+        Bitboard line = LINES.mask[i];
+        Bitboard hole = empty & line;
+        if (!hole || (hole & (hole - 1)) != 0) {
+            continue;
+        }
+        for (int p = 0; p < NUM_PLAYERS; p++) {
+            for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+                if (((board.pieces[p][t] | hole) & line) == line) {
+                    threats[p][t]++;
+                }
+            }
+        }
+    }
+}
+
+// Rasgos de un jugador, ya contados; la evaluación es su suma ponderada
+struct EvalFeatures {
+    int gatos = 0;
+    int gatosInSupply = 0;
+    int gatitos = 0;
+    int center = 0;
+    int edgeGatitos = 0;
+    int gatitoThreats = 0;
+    int gatoThreats = 0;
+};
+
+inline int weighFeatures(const EvalFeatures& f) {
+    return EVAL_GATO_ON_BOARD * f.gatos +
+           EVAL_GATO_IN_SUPPLY * f.gatosInSupply +
+           EVAL_GATITO_ON_BOARD * f.gatitos +
+           EVAL_CENTER * f.center +
+           EVAL_EDGE_GATITO * f.edgeGatitos +
+           EVAL_GATITO_THREAT * f.gatitoThreats +
+           EVAL_GATO_THREAT * f.gatoThreats;
+}
+
+inline int evaluate(const Position& pos) {
+    int threats[NUM_PLAYERS][NUM_PIECE_TYPES];
+    countThreats(pos.board, threats);
+
+    int score[NUM_PLAYERS];
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        Bitboard gatitos = pos.board.pieces[p][0];
+        Bitboard gatos = pos.board.pieces[p][1];
+        EvalFeatures f;
+        f.gatos = popCount(gatos);
+        f.gatosInSupply = pos.gatos_disponibles[p];
+        f.gatitos = popCount(gatitos);
+        f.center = popCount((gatitos | gatos) & CENTER_SQUARES);
+        f.edgeGatitos = popCount(gatitos & EDGE_SQUARES);
+        f.gatitoThreats = threats[p][0];
+        f.gatoThreats = threats[p][1];
+        score[p] = weighFeatures(f);
+    }
+    return score[pos.sideToMove] - score[pos.sideToMove ^ 1];
+}
+
+// Puntuación de una partida terminada desde el punto de vista del que mueve.
+// Al ganar no cambia el turno: sideToMove es quien hizo la última jugada y el
+// nodo se puntúa para su rival
+inline int terminalScore(const Position& pos, int ply) {
+    return pos.winner == pos.sideToMove ? -WIN_SCORE + ply : WIN_SCORE - ply;
+}
+
+inline bool isWinScore(int score) {
+    return score > WIN_SCORE - MAX_WIN_DISTANCE || score < -WIN_SCORE + MAX_WIN_DISTANCE;
+}
+
+#endif // BOOPEVAL_H
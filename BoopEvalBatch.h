@@ -0,0 +1,316 @@
+#ifndef BOOPEVALBATCH_H
+#define BOOPEVALBATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BoopEval.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BOOP_EVAL_X86 1
+#endif
+
+// Evaluación por lotes: muchas posiciones guardadas como arreglos de máscaras
+// (una columna por jugador y tipo) y evaluadas varias a la vez con AVX2 o
+// SSE4.1. Cada resultado es exactamente evaluate() de esa posición; la
+// versión escalar da los mismos números en cualquier procesador.
+// El núcleo se elige al ejecutar según lo que soporta el procesador, así que
+// no hace falta compilar con -mavx2.
+
+enum class EvalKernel {
+    SCALAR,
+    SSE4,
+    AVX2
+};
+
+// El mejor núcleo disponible en este procesador
+inline EvalKernel bestEvalKernel() {
+#ifdef BOOP_EVAL_X86
+    static const EvalKernel best = __builtin_cpu_supports("avx2")     ? EvalKernel::AVX2
+                                   : __builtin_cpu_supports("sse4.1") ? EvalKernel::SSE4
+                                                                      : EvalKernel::SCALAR;
+    return best;
+#else
+    return EvalKernel::SCALAR;
+#endif
+}
+
+inline const char* evalKernelName(EvalKernel kernel) {
+    switch (kernel) {
+        case EvalKernel::AVX2:
+            return "AVX2";
+        case EvalKernel::SSE4:
+            return "SSE4.1";
+        default:
+            return "escalar";
+    }
+}
+
+// Clase EvalBatch
+class EvalBatch {
+public:
+    vector<Bitboard> pieces[NUM_PLAYERS][NUM_PIECE_TYPES];
+    vector<int> gatosInSupply[NUM_PLAYERS];
+    vector<uint8_t> sideToMove;
+
+    int size() const { return static_cast<int>(sideToMove.size()); }
+    void clear();
+    void reserve(size_t count);
+    void add(const Position& pos);
+    // Deja en scores[i] la evaluación de la posición i. Si el procesador no
+    // soporta el núcleo pedido se usa el mejor que sí soporte
+    void evaluate(int* scores, EvalKernel kernel = bestEvalKernel()) const;
+};
+
+// Conteos de un jugador en el orden de EvalFeatures, sin la reserva
+enum EvalCount { COUNT_GATOS, COUNT_GATITOS, COUNT_CENTER, COUNT_EDGE, COUNT_GATITO_THREATS, COUNT_GATO_THREATS, NUM_EVAL_COUNTS };
+
+// Suma ponderada de una posición a partir de sus conteos
+inline int finishBatchScore(const EvalBatch& batch, int i, const uint64_t counts[NUM_PLAYERS][NUM_EVAL_COUNTS]) {
+    int score[NUM_PLAYERS];
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        EvalFeatures f;
+        f.gatos = static_cast<int>(counts[p][COUNT_GATOS]);
+        f.gatosInSupply = batch.gatosInSupply[p][i];
+        f.gatitos = static_cast<int>(counts[p][COUNT_GATITOS]);
+        f.center = static_cast<int>(counts[p][COUNT_CENTER]);
+        f.edgeGatitos = static_cast<int>(counts[p][COUNT_EDGE]);
+        f.gatitoThreats = static_cast<int>(counts[p][COUNT_GATITO_THREATS]);
+        f.gatoThreats = static_cast<int>(counts[p][COUNT_GATO_THREATS]);
+        score[p] = weighFeatures(f);
+    }
+    int side = batch.sideToMove[i];
+    return score[side] - score[side ^ 1];
+}
+
+// Una línea es amenaza de (jugador, tipo) si tiene una sola casilla vacía y
+// las otras dos son de ese jugador y tipo, igual que en countThreats
+inline void evaluateBatchScalar(const EvalBatch& batch, int begin, int end, int* scores) {
+    for (int i = begin; i < end; i++) {
+        Bitboard own[NUM_PLAYERS][NUM_PIECE_TYPES];
+        for (int p = 0; p < NUM_PLAYERS; p++) {
+            for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+                own[p][t] = batch.pieces[p][t][i];
+            }
+        }
+        Bitboard empty = ~(own[0][0] | own[0][1] | own[1][0] | own[1][1]) & ALL_SQUARES;
+
+        uint64_t counts[NUM_PLAYERS][NUM_EVAL_COUNTS] = {};
+        for (int line = 0; line < NUM_LINES; line++) {
+            Bitboard mask = LINES.mask[line];
+            Bitboard hole = empty & mask;
+            if (!hole || (hole & (hole - 1)) != 0) {
+                continue;
+            }
+            for (int p = 0; p < NUM_PLAYERS; p++) {
+                counts[p][COUNT_GATITO_THREATS] += ((own[p][0] | hole) & mask) == mask;
+                counts[p][COUNT_GATO_THREATS] += ((own[p][1] | hole) & mask) == mask;
+            }
+        }
+        for (int p = 0; p < NUM_PLAYERS; p++) {
+            counts[p][COUNT_GATOS] = popCount(own[p][1]);
+            counts[p][COUNT_GATITOS] = popCount(own[p][0]);
+            counts[p][COUNT_CENTER] = popCount((own[p][0] | own[p][1]) & CENTER_SQUARES);
+            counts[p][COUNT_EDGE] = popCount(own[p][0] & EDGE_SQUARES);
+        }
+        scores[i] = finishBatchScore(batch, i, counts);
+    }
+}
+
+#ifdef BOOP_EVAL_X86
+
+// Conteo de bits por palabra de 64 bits: tabla de 16 entradas por nibble
+// con pshufb y suma horizontal de bytes con psadbw
+__attribute__((target("sse4.1"))) inline __m128i popCount128(__m128i v) {
+    const __m128i table = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i low = _mm_shuffle_epi8(table, _mm_and_si128(v, nibble));
+    __m128i high = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+    return _mm_sad_epu8(_mm_add_epi8(low, high), _mm_setzero_si128());
+}
+
+// Dos posiciones por iteración en registros de 128 bits
+__attribute__((target("sse4.1"))) inline void evaluateBatchSSE4(const EvalBatch& batch, int begin, int end,
+                                                                int* scores) {
+    const int lanes = 2;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi64x(1);
+    const __m128i all = _mm_set1_epi64x(static_cast<long long>(ALL_SQUARES));
+    const __m128i center = _mm_set1_epi64x(static_cast<long long>(CENTER_SQUARES));
+    const __m128i edge = _mm_set1_epi64x(static_cast<long long>(EDGE_SQUARES));
+
+    int i = begin;
+    for (; i + lanes <= end; i += lanes) {
+        __m128i own[NUM_PLAYERS][NUM_PIECE_TYPES];
+        for (int p = 0; p < NUM_PLAYERS; p++) {
+            for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+                own[p][t] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(batch.pieces[p][t].data() + i));
+            }
+        }
+        __m128i occupied = _mm_or_si128(_mm_or_si128(own[0][0], own[0][1]), _mm_or_si128(own[1][0], own[1][1]));
+        __m128i empty = _mm_andnot_si128(occupied, all);
+
+        // Las comparaciones dan -1 por carril verdadero, así que se restan
+        __m128i threats[NUM_PLAYERS][NUM_PIECE_TYPES] = {{zero, zero}, {zero, zero}};
+        for (int line = 0; line < NUM_LINES; line++) {
+            __m128i mask = _mm_set1_epi64x(static_cast<long long>(LINES.mask[line]));
+            __m128i hole = _mm_and_si128(empty, mask);
+            __m128i single = _mm_andnot_si128(_mm_cmpeq_epi64(hole, zero),
+                                              _mm_cmpeq_epi64(_mm_and_si128(hole, _mm_sub_epi64(hole, one)), zero));
+            for (int p = 0; p < NUM_PLAYERS; p++) {
+                for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+                    __m128i full = _mm_cmpeq_epi64(_mm_and_si128(_mm_or_si128(own[p][t], hole), mask), mask);
+                    threats[p][t] = _mm_sub_epi64(threats[p][t], _mm_and_si128(single, full));
+                }
+            }
+        }
+
+        alignas(16) uint64_t lane[NUM_PLAYERS][NUM_EVAL_COUNTS][lanes];
+        for (int p = 0; p < NUM_PLAYERS; p++) {
+            __m128i any = _mm_or_si128(own[p][0], own[p][1]);
+            _mm_store_si128(reinterpret_cast<__m128i*>(lane[p][COUNT_GATOS]), popCount128(own[p][1]));
+            _mm_store_si128(reinterpret_cast<__m128i*>(lane[p][COUNT_GATITOS]), popCount128(own[p][0]));
+            _mm_store_si128(reinterpret_cast<__m128i*>(lane[p][COUNT_CENTER]), popCount128(_mm_and_si128(any, center)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(lane[p][COUNT_EDGE]), popCount128(_mm_and_si128(own[p][0], edge)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(lane[p][COUNT_GATITO_THREATS]), threats[p][0]);
+            _mm_store_si128(reinterpret_cast<__m128i*>(lane[p][COUNT_GATO_THREATS]), threats[p][1]);
+        }
+        for (int l = 0; l < lanes; l++) {
+            uint64_t counts[NUM_PLAYERS][NUM_EVAL_COUNTS];
+            for (int p = 0; p < NUM_PLAYERS; p++) {
+                for (int c = 0; c < NUM_EVAL_COUNTS; c++) {
+                    counts[p][c] = lane[p][c][l];
+                }
+            }
+            scores[i + l] = finishBatchScore(batch, i + l, counts);
+        }
+    }
+    evaluateBatchScalar(batch, i, end, scores);
+}
+
+__attribute__((target("avx2"))) inline __m256i popCount256(__m256i v) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble));
+    __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+// Cuatro posiciones por iteración en registros de 256 bits
+__attribute__((target("avx2"))) inline void evaluateBatchAVX2(const EvalBatch& batch, int begin, int end,
+                                                              int* scores) {
+    const int lanes = 4;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i all = _mm256_set1_epi64x(static_cast<long long>(ALL_SQUARES));
+    const __m256i center = _mm256_set1_epi64x(static_cast<long long>(CENTER_SQUARES));
+    const __m256i edge = _mm256_set1_epi64x(static_cast<long long>(EDGE_SQUARES));
+
+    int i = begin;
+    for (; i + lanes <= end; i += lanes) {
+        __m256i own[NUM_PLAYERS][NUM_PIECE_TYPES];
+        for (int p = 0; p < NUM_PLAYERS; p++) {
+            for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+                own[p][t] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(batch.pieces[p][t].data() + i));
+            }
+        }
+        __m256i occupied =
+            _mm256_or_si256(_mm256_or_si256(own[0][0], own[0][1]), _mm256_or_si256(own[1][0], own[1][1]));
+        __m256i empty = _mm256_andnot_si256(occupied, all);
+
+        __m256i threats[NUM_PLAYERS][NUM_PIECE_TYPES] = {{zero, zero}, {zero, zero}};
+        for (int line = 0; line < NUM_LINES; line++) {
+            __m256i mask = _mm256_set1_epi64x(static_cast<long long>(LINES.mask[line]));
+            __m256i hole = _mm256_and_si256(empty, mask);
+            __m256i single =
+                _mm256_andnot_si256(_mm256_cmpeq_epi64(hole, zero),
+                                    _mm256_cmpeq_epi64(_mm256_and_si256(hole, _mm256_sub_epi64(hole, one)), zero));
+            for (int p = 0; p < NUM_PLAYERS; p++) {
+                for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+                    __m256i full =
+                        _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_or_si256(own[p][t], hole), mask), mask);
+                    threats[p][t] = _mm256_sub_epi64(threats[p][t], _mm256_and_si256(single, full));
+                }
+            }
+        }
+
+        alignas(32) uint64_t lane[NUM_PLAYERS][NUM_EVAL_COUNTS][lanes];
+        for (int p = 0; p < NUM_PLAYERS; p++) {
+            __m256i any = _mm256_or_si256(own[p][0], own[p][1]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lane[p][COUNT_GATOS]), popCount256(own[p][1]));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lane[p][COUNT_GATITOS]), popCount256(own[p][0]));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lane[p][COUNT_CENTER]),
+                               popCount256(_mm256_and_si256(any, center)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lane[p][COUNT_EDGE]),
+                               popCount256(_mm256_and_si256(own[p][0], edge)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lane[p][COUNT_GATITO_THREATS]), threats[p][0]);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lane[p][COUNT_GATO_THREATS]), threats[p][1]);
+        }
+        for (int l = 0; l < lanes; l++) {
+            uint64_t counts[NUM_PLAYERS][NUM_EVAL_COUNTS];
+            for (int p = 0; p < NUM_PLAYERS; p++) {
+                for (int c = 0; c < NUM_EVAL_COUNTS; c++) {
+                    counts[p][c] = lane[p][c][l];
+                }
+            }
+            scores[i + l] = finishBatchScore(batch, i + l, counts);
+        }
+    }
+    evaluateBatchScalar(batch, i, end, scores);
+}
+
+#endif // BOOP_EVAL_X86
+
+inline void EvalBatch::clear() {
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            pieces[p][t].clear();
+        }
+        gatosInSupply[p].clear();
+    }
+    sideToMove.clear();
+}
+
+inline void EvalBatch::reserve(size_t count) {
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            pieces[p][t].reserve(count);
+        }
+        gatosInSupply[p].reserve(count);
+    }
+    sideToMove.reserve(count);
+}
+
+inline void EvalBatch::add(const Position& pos) {
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            pieces[p][t].push_back(pos.board.pieces[p][t]);
+        }
+        gatosInSupply[p].push_back(pos.gatos_disponibles[p]);
+    }
+    sideToMove.push_back(static_cast<uint8_t>(pos.sideToMove));
+}
+
+inline void EvalBatch::evaluate(int* scores, EvalKernel kernel) const {
+    if (kernel > bestEvalKernel()) {
+        kernel = bestEvalKernel();
+    }
+    switch (kernel) {
+#ifdef BOOP_EVAL_X86
+        case EvalKernel::AVX2:
+            evaluateBatchAVX2(*this, 0, size(), scores);
+            break;
+        case EvalKernel::SSE4:
+            evaluateBatchSSE4(*this, 0, size(), scores);
+            break;
+#endif
+        default:
+            evaluateBatchScalar(*this, 0, size(), scores);
+            break;
+    }
+}
+
+#endif // BOOPEVALBATCH_H
@@ -0,0 +1,114 @@
+#ifndef BOOPEVENTS_H
+#define BOOPEVENTS_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BoopBitboard.h"
+
+// Eventos del núcleo de reglas. Boop no escribe en pantalla: avisa de cada
+// cambio a un receptor elegido en tiempo de compilación. Un receptor es
+// cualquier clase con estos métodos:
+//   onPlaced(player, type, sq)     pieza colocada
+//   onBooped(player, from, to)     gatito empujado dentro del tablero
+//   onBoopedOut(player, type, sq)  pieza expulsada, vuelve a la reserva
+//   onGraduated(player, line)      línea de gatitos graduada (índice en LINES)
+//   onWon(player)                  tres gatos en línea
+//   onRejected(reason)             jugada rechazada
+
+enum class RejectReason : uint8_t {
+    GAME_OVER,
+    OCCUPIED,
+    NO_GATITOS,
+    NO_GATOS
+};
+
+// Receptor vacío: con él las reglas no hacen ninguna entrada/salida
+struct NullEventSink {
+    void onPlaced(int, PieceType, int) {}
+    void onBooped(int, int, int) {}
+    void onBoopedOut(int, PieceType, int) {}
+    void onGraduated(int, int) {}
+    void onWon(int) {}
+    void onRejected(RejectReason) {}
+};
+
+// Receptor de texto para el juego interactivo: guarda los mensajes en un
+// buffer y los escribe de una vez con flush() o al destruirse
+class TextEventSink {
+public:
+    TextEventSink(std::ostream& out, const std::string& name1, const std::string& name2)
+        : out(out), names{&name1, &name2} {}
+    ~TextEventSink() { flush(); }
+
+    void onPlaced(int, PieceType, int) {}
+    void onBooped(int, int, int) {}
+    void onBoopedOut(int, PieceType, int) {}
+
+    void onGraduated(int player, int) {
+        buffer += "¡" + *names[player] + " ha graduado a 3 gatitos!\n";
+    }
+
+    void onWon(int player) {
+        buffer += "¡" + *names[player] + " ha ganado con 3 gatos adultos en línea!\n";
+    }
+
+    void onRejected(RejectReason reason) {
+        switch (reason) {
+            case RejectReason::GAME_OVER:
+                buffer += "El juego ha terminado!\n";
+                break;
+            case RejectReason::OCCUPIED:
+                buffer += "Esa posición ya está ocupada!\n";
+                break;
+            case RejectReason::NO_GATITOS:
+                buffer += "No tienes más gatitos disponibles!\n";
+                break;
+            case RejectReason::NO_GATOS:
+                buffer += "No tienes gatos disponibles!\n";
+                break;
+        }
+    }
+
+    void flush() {
+        if (!buffer.empty()) {
+            out << buffer << std::flush;
+            buffer.clear();
+        }
+    }
+
+private:
+    std::ostream& out;
+    const std::string* names[NUM_PLAYERS];
+    std::string buffer;
+};
+
+// Receptor binario: cada evento es un registro de 4 bytes
+// (tipo de evento, jugador o motivo, casilla o línea, casilla destino o tipo)
+class BinaryEventSink {
+public:
+    enum Kind : uint8_t { PLACED, BOOPED, BOOPED_OUT, GRADUATED, WON, REJECTED };
+
+    std::vector<uint8_t> records;
+
+    void onPlaced(int player, PieceType type, int sq) { append(PLACED, player, sq, typeIndex(type)); }
+    void onBooped(int player, int from, int to) { append(BOOPED, player, from, to); }
+    void onBoopedOut(int player, PieceType type, int sq) { append(BOOPED_OUT, player, sq, typeIndex(type)); }
+    void onGraduated(int player, int line) { append(GRADUATED, player, line, 0); }
+    void onWon(int player) { append(WON, player, 0, 0); }
+    void onRejected(RejectReason reason) { append(REJECTED, static_cast<int>(reason), 0, 0); }
+
+    void clear() { records.clear(); }
+
+private:
+    void append(Kind kind, int a, int b, int c) {
+        records.push_back(kind);
+        records.push_back(static_cast<uint8_t>(a));
+        records.push_back(static_cast<uint8_t>(b));
+        records.push_back(static_cast<uint8_t>(c));
+    }
+};
+
+#endif // BOOPEVENTS_H
@@ -10,29 +10,27 @@
 #include <algorithm>
 #include <tuple>
 
+#include "BoopEvents.h"
+#include "BoopLineCounters.h"
+#include "BoopMetrics.h"
+#include "BoopPosition.h"
+
 using namespace std;
 
 // Forward declarations
 class Player;
-class Piece;
-class Gatito;
-class Gato;
-
-// Enumeración para tipos de pieza
-enum class PieceType {
-    GATITO = 1,
-    GATO = 2
-};
+class Searcher;
 
 // Clase Player
 class Player {
 public:
     string name;
     string color;
+    int index;
     int gatitos_disponibles;
     int gatos_disponibles;
 
-    Player(const string& n, const string& c);
+    Player(const string& n, const string& c, int gatitos = INITIAL_GATITOS);
     bool canPlaceGatito() const;
     bool canPlaceGato() const;
     void useGatito();
@@ -42,80 +40,126 @@ public:
     void promoteGatitosToGato(int count = 3);
 };
 
-// Clase base abstracta Piece
+// Rasgos de cada tipo de pieza, indexados por typeIndex
+constexpr int PIECE_WEIGHT[NUM_PIECE_TYPES] = {1, 2};
+// Solo los gatitos pueden ser empujados por un boop
+constexpr bool PIECE_CAN_BOOP[NUM_PIECE_TYPES] = {true, false};
+constexpr char PIECE_SYMBOL[NUM_PLAYERS][NUM_PIECE_TYPES] = {{'o', 'O'}, {'x', 'X'}};
+
+// Pieza como valor de un byte guardado directamente en el tablero:
+// 0 es una casilla vacía y si no el código es 1 + jugador * 2 + tipo
 class Piece {
 public:
-    pair<int, int> position;
-    Player* player;
-    PieceType piece_type;
-
-    Piece(pair<int, int> pos, Player* p, PieceType type);
-    virtual ~Piece() = default;
-    virtual int weight() const = 0;
-    virtual bool canBoop() const = 0;
-    virtual char getSymbol() const = 0;
+    constexpr Piece() : code(0) {}
+    constexpr Piece(int owner, PieceType type)
+        : code(static_cast<uint8_t>(1 + owner * NUM_PIECE_TYPES + typeIndex(type))) {}
+
+    constexpr bool isEmpty() const { return code == 0; }
+    constexpr explicit operator bool() const { return code != 0; }
+    constexpr int owner() const { return (code - 1) / NUM_PIECE_TYPES; }
+    constexpr PieceType type() const { return typeFromIndex((code - 1) % NUM_PIECE_TYPES); }
+    constexpr int weight() const { return PIECE_WEIGHT[(code - 1) % NUM_PIECE_TYPES]; }
+    constexpr bool canBoop() const { return PIECE_CAN_BOOP[(code - 1) % NUM_PIECE_TYPES]; }
+    constexpr char getSymbol() const { return PIECE_SYMBOL[owner()][(code - 1) % NUM_PIECE_TYPES]; }
+
+    constexpr bool operator==(const Piece& other) const { return code == other.code; }
+    constexpr bool operator!=(const Piece& other) const { return code != other.code; }
+
+private:
+    uint8_t code;
 };
 
-// Clase Gatito
-class Gatito : public Piece {
-public:
-    Gatito(pair<int, int> pos, Player* p);
-    int weight() const override;
-    bool canBoop() const override;
-    char getSymbol() const override;
-};
+static_assert(sizeof(Piece) == 1, "Piece debe ocupar un byte");
 
-// Clase Gato
-class Gato : public Piece {
-public:
-    Gato(pair<int, int> pos, Player* p);
-    int weight() const override;
-    bool canBoop() const override;
-    char getSymbol() const override;
+// Piezas expulsadas del tablero por un boop, en un buffer de tamaño fijo
+struct BoopedOutPieces {
+    Piece pieces[NUM_DIRECTIONS];
+    int count = 0;
+    // Gatitos que el boop movió sin sacarlos del tablero
+    int pushedCount = 0;
+
+    const Piece* begin() const { return pieces; }
+    const Piece* end() const { return pieces + count; }
+    int size() const { return count; }
 };
 
-// Clase Board
-class Board {
+// Clase Board, de NxN casillas
+template <int N>
+class BasicBoard {
 public:
-    int size;
-    vector<vector<Piece*>> grid;
+    using Geometry = BoardGeometry<N>;
+    static constexpr int size = N;
+
+    Piece grid[N][N];
+    BasicBitBoard<N> bits;
+    // Contadores de cada línea de tres, al día con cada cambio del tablero
+    BasicLineCounters<N> lines;
 
-    Board(int s = 6);
-    ~Board();
     bool isValidPosition(int row, int col) const;
     bool isEmpty(int row, int col) const;
-    bool placePiece(Piece* piece, int row, int col);
-    Piece* removePiece(int row, int col);
-    Piece* getPiece(int row, int col) const;
+    bool placePiece(Piece piece, int row, int col);
+    Piece removePiece(int row, int col);
+    Piece getPiece(int row, int col) const;
     vector<pair<int, int>> getAdjacentPositions(int row, int col) const;
-    vector<Piece*> boopPieces(int placedRow, int placedCol, Piece* placedPiece);
+    template <class Sink>
+    BoopedOutPieces boopPieces(int placedRow, int placedCol, Sink& events);
     vector<vector<pair<int, int>>> findLinesOfThree(Player* player) const;
     void display() const;
 };
 
-// Clase principal del juego Boop
-class Boop {
+using Board = BasicBoard<BOARD_SIZE>;
+
+// Clase principal del juego Boop, con un tablero de NxN y Supply gatitos
+// por jugador. Boop es el juego estándar y el único con partida interactiva
+template <int N, int Supply>
+class BasicBoop {
 public:
-    Board board;
+    using Geometry = BoardGeometry<N>;
+    using PositionType = BasicPosition<N, Supply>;
+
+    BasicBoard<N> board;
     Player player1;
     Player player2;
     Player* currentPlayer;
     bool gameOver;
     Player* winner;
-
-    Boop();
+    // Buscador que juega por cada asiento, o nullptr si juega una persona
+    Searcher* computerPlayers[2];
+    // Claves Zobrist de las posiciones ya jugadas, para detectar repeticiones
+    vector<uint64_t> keyHistory;
+
+    BasicBoop();
+    // Las copias apuntan a sus propios jugadores, no a los del original
+    BasicBoop(const BasicBoop& other);
+    BasicBoop& operator=(const BasicBoop& other);
     void switchPlayer();
+    Player* playerAt(int index);
+    // Reglas sin salida por pantalla: cada cambio se avisa al receptor
+    template <class Sink>
+    bool placePiece(int row, int col, PieceType pieceType, Sink& events);
+    // Jugada del juego interactivo, con los mensajes en texto
     bool placePiece(int row, int col, PieceType pieceType);
-    void checkAndPromoteGatitos();
-    void checkVictory();
+    // Devuelve las líneas graduadas
+    template <class Sink>
+    int checkAndPromoteGatitos(Sink& events);
+    template <class Sink>
+    void checkVictory(Sink& events);
     void displayGameState() const;
+    PositionType position() const;
+    void setPosition(const PositionType& pos);
     tuple<int, int, PieceType> getPlayerInput();
     void play();
+
+private:
+    // Clave Zobrist del estado actual, sin construir una Position
+    uint64_t currentKey() const;
 };
 
+using Boop = BasicBoop<BOARD_SIZE, INITIAL_GATITOS>;
+
 // Implementaciones inline de Player
-inline Player::Player(const string& n, const string& c) 
-    : name(n), color(c), gatitos_disponibles(8), gatos_disponibles(0) {}
+inline Player::Player(const string& n, const string& c, int gatitos)
+    : name(n), color(c), index(c == "orange" ? 0 : 1), gatitos_disponibles(gatitos), gatos_disponibles(0) {}
 
 inline bool Player::canPlaceGatito() const {
     return gatitos_disponibles > 0;
@@ -150,166 +194,125 @@ inline void Player::promoteGatitosToGato(int count) {
     gatos_disponibles += 3;
 }
 
-// Implementaciones inline de Piece
-inline Piece::Piece(pair<int, int> pos, Player* p, PieceType type) 
-    : position(pos), player(p), piece_type(type) {}
-
-// Implementaciones inline de Gatito
-inline Gatito::Gatito(pair<int, int> pos, Player* p) 
-    : Piece(pos, p, PieceType::GATITO) {}
-
-inline int Gatito::weight() const {
-    return 1;
-}
-
-inline bool Gatito::canBoop() const {
-    return true;
-}
-
-inline char Gatito::getSymbol() const {
-    return player->color == "orange" ? 'o' : 'x';
-}
-
-// Implementaciones inline de Gato
-inline Gato::Gato(pair<int, int> pos, Player* p) 
-    : Piece(pos, p, PieceType::GATO) {}
-
-inline int Gato::weight() const {
-    return 2;
-}
-
-inline bool Gato::canBoop() const {
-    return false;
-}
-
-inline char Gato::getSymbol() const {
-    return player->color == "orange" ? 'O' : 'X';
-}
-
 // Implementaciones inline de Board
-inline Board::Board(int s) : size(s) {
-    grid.resize(size, vector<Piece*>(size, nullptr));
-}
-
-inline Board::~Board() {
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            delete grid[i][j];
-        }
-    }
-}
 
-inline bool Board::isValidPosition(int row, int col) const {
+template <int N>
+inline bool BasicBoard<N>::isValidPosition(int row, int col) const {
     return row >= 0 && row < size && col >= 0 && col < size;
 }
 
-inline bool Board::isEmpty(int row, int col) const {
-    return isValidPosition(row, col) && grid[row][col] == nullptr;
+template <int N>
+inline bool BasicBoard<N>::isEmpty(int row, int col) const {
+    return isValidPosition(row, col) && bits.isEmpty(Geometry::squareOf(row, col));
 }
 
-inline bool Board::placePiece(Piece* piece, int row, int col) {
+template <int N>
+inline bool BasicBoard<N>::placePiece(Piece piece, int row, int col) {
     if (isEmpty(row, col)) {
+        int sq = Geometry::squareOf(row, col);
         grid[row][col] = piece;
-        piece->position = {row, col};
+        bits.set(piece.owner(), typeIndex(piece.type()), sq);
+        lines.add(piece.owner(), typeIndex(piece.type()), sq);
         return true;
     }
     return false;
 }
 
-inline Piece* Board::removePiece(int row, int col) {
+template <int N>
+inline Piece BasicBoard<N>::removePiece(int row, int col) {
     if (isValidPosition(row, col)) {
-        Piece* piece = grid[row][col];
-        grid[row][col] = nullptr;
+        Piece piece = grid[row][col];
+        grid[row][col] = Piece();
+        if (piece) {
+            int sq = Geometry::squareOf(row, col);
+            bits.clear(piece.owner(), typeIndex(piece.type()), sq);
+            lines.remove(piece.owner(), typeIndex(piece.type()), sq);
+        }
         return piece;
     }
-    return nullptr;
+    return Piece();
 }
 
-inline Piece* Board::getPiece(int row, int col) const {
+template <int N>
+inline Piece BasicBoard<N>::getPiece(int row, int col) const {
     if (isValidPosition(row, col)) {
         return grid[row][col];
     }
-    return nullptr;
+    return Piece();
 }
 
-inline vector<pair<int, int>> Board::getAdjacentPositions(int row, int col) const {
+template <int N>
+inline vector<pair<int, int>> BasicBoard<N>::getAdjacentPositions(int row, int col) const {
     vector<pair<int, int>> adjacent;
-    int directions[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
-    
-    for (int i = 0; i < 8; i++) {
-        int newRow = row + directions[i][0];
-        int newCol = col + directions[i][1];
-        if (isValidPosition(newRow, newCol)) {
-            adjacent.push_back({newRow, newCol});
+    if (!isValidPosition(row, col)) {
+        return adjacent;
+    }
+
+    int sq = Geometry::squareOf(row, col);
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        int adj = NEIGHBOR_TABLE<N>.neighbor[sq][d];
+        if (adj != OFF_BOARD) {
+            adjacent.push_back({Geometry::rowOf(adj), Geometry::colOf(adj)});
         }
     }
     return adjacent;
 }
 
-inline vector<Piece*> Board::boopPieces(int placedRow, int placedCol, Piece* placedPiece) {
-    vector<Piece*> boopedOut;
-    vector<pair<int, int>> adjacentPositions = getAdjacentPositions(placedRow, placedCol);
-
-    for (const auto& pos : adjacentPositions) {
-        int adjRow = pos.first;
-        int adjCol = pos.second;
-        Piece* piece = getPiece(adjRow, adjCol);
-        
-        if (piece && piece->canBoop()) {
-            int dr = adjRow - placedRow;
-            int dc = adjCol - placedCol;
-            int newRow = adjRow + dr;
-            int newCol = adjCol + dc;
-
-            if (isValidPosition(newRow, newCol) && isEmpty(newRow, newCol)) {
-                removePiece(adjRow, adjCol);
-                placePiece(piece, newRow, newCol);
-            } else if (!isValidPosition(newRow, newCol)) {
-                removePiece(adjRow, adjCol);
-                boopedOut.push_back(piece);
-            }
-        }
+template <int N>
+template <class Sink>
+inline BoopedOutPieces BasicBoard<N>::boopPieces(int placedRow, int placedCol, Sink& events) {
+    BoopedOutPieces boopedOut;
+    BoopResult result;
+    boopAround(bits, Geometry::squareOf(placedRow, placedCol), result);
+    boopedOut.pushedCount = result.pushedCount;
+
+    // Las máscaras ya están actualizadas; solo falta copiar las piezas del grid
+    // y mover los contadores de líneas. Solo se empujan gatitos
+    const int gatito = typeIndex(PieceType::GATITO);
+    for (int i = 0; i < result.pushedCount; i++) {
+        int from = result.pushedFrom[i];
+        int to = result.pushedTo[i];
+        Piece piece = grid[Geometry::rowOf(from)][Geometry::colOf(from)];
+        grid[Geometry::rowOf(to)][Geometry::colOf(to)] = piece;
+        grid[Geometry::rowOf(from)][Geometry::colOf(from)] = Piece();
+        lines.remove(piece.owner(), gatito, from);
+        lines.add(piece.owner(), gatito, to);
+        events.onBooped(piece.owner(), from, to);
+    }
+    for (int i = 0; i < result.outCount; i++) {
+        int sq = result.outSquare[i];
+        Piece piece = grid[Geometry::rowOf(sq)][Geometry::colOf(sq)];
+        boopedOut.pieces[boopedOut.count++] = piece;
+        grid[Geometry::rowOf(sq)][Geometry::colOf(sq)] = Piece();
+        lines.remove(piece.owner(), gatito, sq);
+        events.onBoopedOut(piece.owner(), piece.type(), sq);
     }
     return boopedOut;
 }
 
-inline vector<vector<pair<int, int>>> Board::findLinesOfThree(Player* player) const {
-    vector<vector<pair<int, int>>> lines;
-    int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
-
-    for (int row = 0; row < size; row++) {
-        for (int col = 0; col < size; col++) {
-            Piece* piece = getPiece(row, col);
-            if (piece && piece->player == player) {
-                for (int d = 0; d < 4; d++) {
-                    vector<pair<int, int>> line = {{row, col}};
-                    int dr = directions[d][0];
-                    int dc = directions[d][1];
-
-                    for (int i = 1; i < 3; i++) {
-                        int newRow = row + i * dr;
-                        int newCol = col + i * dc;
-                        Piece* nextPiece = getPiece(newRow, newCol);
-                        
-                        if (nextPiece && nextPiece->player == player &&
-                            nextPiece->piece_type == piece->piece_type) {
-                            line.push_back({newRow, newCol});
-                        } else {
-                            break;
-                        }
-                    }
-
-                    if (line.size() == 3) {
-                        lines.push_back(line);
-                    }
-                }
+template <int N>
+inline vector<vector<pair<int, int>>> BasicBoard<N>::findLinesOfThree(Player* player) const {
+    countMetric(MetricCounter::LINE_SCANS);
+    vector<vector<pair<int, int>>> found;
+    const Bitboard* gatitos = lines.completeLines(player->index, 0);
+    const Bitboard* gatos = lines.completeLines(player->index, 1);
+
+    for (int w = 0; w < BasicLineCounters<N>::LINE_WORDS; w++) {
+        Bitboard complete = gatitos[w] | gatos[w];
+        while (complete) {
+            int line = w * 64 + popLsb(complete);
+            vector<pair<int, int>> cells;
+            for (int sq : LINE_TABLE<N>.squares[line]) {
+                cells.push_back({Geometry::rowOf(sq), Geometry::colOf(sq)});
             }
+            found.push_back(cells);
         }
     }
-    return lines;
+    return found;
 }
 
-inline void Board::display() const {
+template <int N>
+inline void BasicBoard<N>::display() const {
     cout << "  ";
     for (int col = 0; col < size; col++) {
         cout << " " << col << " ";
@@ -319,11 +322,11 @@ inline void Board::display() const {
     for (int row = 0; row < size; row++) {
         cout << row << " ";
         for (int col = 0; col < size; col++) {
-            Piece* piece = getPiece(row, col);
-            if (piece == nullptr) {
+            Piece piece = getPiece(row, col);
+            if (piece.isEmpty()) {
                 cout << " . ";
             } else {
-                cout << " " << piece->getSymbol() << " ";
+                cout << " " << piece.getSymbol() << " ";
             }
         }
         cout << endl;
@@ -331,14 +334,205 @@ inline void Board::display() const {
 }
 
 // Implementaciones inline de Boop
-inline Boop::Boop() : player1("Jugador 1", "orange"), player2("Jugador 2", "gray"),
-         currentPlayer(&player1), gameOver(false), winner(nullptr) {}
+template <int N, int Supply>
+inline BasicBoop<N, Supply>::BasicBoop() : player1("Jugador 1", "orange", Supply), player2("Jugador 2", "gray", Supply),
+         currentPlayer(&player1), gameOver(false), winner(nullptr),
+         computerPlayers{nullptr, nullptr} {
+    keyHistory.reserve(MAX_PLY);
+    keyHistory.push_back(currentKey());
+}
+
+template <int N, int Supply>
+inline BasicBoop<N, Supply>::BasicBoop(const BasicBoop& other) : player1(other.player1), player2(other.player2) {
+    keyHistory.reserve(MAX_PLY);
+    *this = other;
+}
 
-inline void Boop::switchPlayer() {
+template <int N, int Supply>
+inline BasicBoop<N, Supply>& BasicBoop<N, Supply>::operator=(const BasicBoop& other) {
+    board = other.board;
+    player1 = other.player1;
+    player2 = other.player2;
+    currentPlayer = playerAt(other.currentPlayer->index);
+    gameOver = other.gameOver;
+    winner = other.winner ? playerAt(other.winner->index) : nullptr;
+    computerPlayers[0] = other.computerPlayers[0];
+    computerPlayers[1] = other.computerPlayers[1];
+    keyHistory = other.keyHistory;
+    return *this;
+}
+
+template <int N, int Supply>
+inline void BasicBoop<N, Supply>::switchPlayer() {
     currentPlayer = (currentPlayer == &player1) ? &player2 : &player1;
 }
 
-inline void Boop::displayGameState() const {
+template <int N, int Supply>
+inline Player* BasicBoop<N, Supply>::playerAt(int index) {
+    return index == player1.index ? &player1 : &player2;
+}
+
+template <int N, int Supply>
+template <class Sink>
+inline bool BasicBoop<N, Supply>::placePiece(int row, int col, PieceType pieceType, Sink& events) {
+    if (gameOver) {
+        countMetric(MetricCounter::REJECTED_MOVES);
+        events.onRejected(RejectReason::GAME_OVER);
+        return false;
+    }
+
+    if (!board.isEmpty(row, col)) {
+        countMetric(MetricCounter::REJECTED_MOVES);
+        events.onRejected(RejectReason::OCCUPIED);
+        return false;
+    }
+
+    if (pieceType == PieceType::GATITO && !currentPlayer->canPlaceGatito()) {
+        countMetric(MetricCounter::REJECTED_MOVES);
+        events.onRejected(RejectReason::NO_GATITOS);
+        return false;
+    } else if (pieceType == PieceType::GATO && !currentPlayer->canPlaceGato()) {
+        countMetric(MetricCounter::REJECTED_MOVES);
+        events.onRejected(RejectReason::NO_GATOS);
+        return false;
+    }
+
+    if (pieceType == PieceType::GATITO) {
+        currentPlayer->useGatito();
+    } else {
+        currentPlayer->useGato();
+    }
+
+    board.placePiece(Piece(currentPlayer->index, pieceType), row, col);
+    events.onPlaced(currentPlayer->index, pieceType, Geometry::squareOf(row, col));
+
+    BoopedOutPieces boopedOut = board.boopPieces(row, col, events);
+
+    for (Piece boopedPiece : boopedOut) {
+        if (boopedPiece.type() == PieceType::GATITO) {
+            playerAt(boopedPiece.owner())->returnGatito();
+        } else {
+            playerAt(boopedPiece.owner())->returnGato();
+        }
+    }
+
+    int graduated = checkAndPromoteGatitos(events);
+    checkVictory(events);
+    countPlacedMove(boopedOut.pushedCount, boopedOut.count, graduated, gameOver);
+
+    if (!gameOver) {
+        switchPlayer();
+    }
+    keyHistory.push_back(currentKey());
+
+    return true;
+}
+
+template <int N, int Supply>
+inline bool BasicBoop<N, Supply>::placePiece(int row, int col, PieceType pieceType) {
+    TextEventSink events(cout, player1.name, player2.name);
+    return placePiece(row, col, pieceType, events);
+}
+
+template <int N, int Supply>
+template <class Sink>
+inline int BasicBoop<N, Supply>::checkAndPromoteGatitos(Sink& events) {
+    Player* players[] = {&player1, &player2};
+    const int gatito = typeIndex(PieceType::GATITO);
+    int graduated = 0;
+
+    for (Player* player : players) {
+        const Bitboard* complete = board.lines.completeLines(player->index, gatito);
+        for (int w = 0; w < BasicLineCounters<N>::LINE_WORDS; w++) {
+            // Las graduaciones solo quitan líneas del conjunto, así que basta
+            // con recorrer una copia en el orden de la tabla de líneas
+            Bitboard pending = complete[w];
+            while (pending) {
+                int line = w * 64 + popLsb(pending);
+
+                // Una línea que comparte casillas con otra ya graduada queda incompleta
+                if (!board.lines.isComplete(player->index, gatito, line)) {
+                    continue;
+                }
+
+                for (int sq : LINE_TABLE<N>.squares[line]) {
+                    board.removePiece(Geometry::rowOf(sq), Geometry::colOf(sq));
+                }
+                player->promoteGatitosToGato(3);
+                events.onGraduated(player->index, line);
+                graduated++;
+            }
+        }
+    }
+    return graduated;
+}
+
+template <int N, int Supply>
+template <class Sink>
+inline void BasicBoop<N, Supply>::checkVictory(Sink& events) {
+    Player* players[] = {&player1, &player2};
+    const int gato = typeIndex(PieceType::GATO);
+
+    for (Player* player : players) {
+        if (board.lines.hasCompleteLine(player->index, gato)) {
+            gameOver = true;
+            winner = player;
+            events.onWon(player->index);
+            return;
+        }
+    }
+}
+
+template <int N, int Supply>
+inline typename BasicBoop<N, Supply>::PositionType BasicBoop<N, Supply>::position() const {
+    PositionType pos;
+    pos.board = board.bits;
+    const Player* players[] = {&player1, &player2};
+    for (const Player* player : players) {
+        pos.gatitos_disponibles[player->index] = player->gatitos_disponibles;
+        pos.gatos_disponibles[player->index] = player->gatos_disponibles;
+    }
+    pos.sideToMove = currentPlayer->index;
+    pos.gameOver = gameOver;
+    pos.winner = winner ? winner->index : -1;
+    pos.refreshKey();
+    return pos;
+}
+
+// Carga una posición del núcleo de reglas; el historial empieza en ella
+template <int N, int Supply>
+inline void BasicBoop<N, Supply>::setPosition(const PositionType& pos) {
+    board = BasicBoard<N>();
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            Bitboard pieces = pos.board.pieces[p][t];
+            while (pieces) {
+                int sq = popLsb(pieces);
+                board.placePiece(Piece(p, typeFromIndex(t)), Geometry::rowOf(sq), Geometry::colOf(sq));
+            }
+        }
+        playerAt(p)->gatitos_disponibles = pos.gatitos_disponibles[p];
+        playerAt(p)->gatos_disponibles = pos.gatos_disponibles[p];
+    }
+    currentPlayer = playerAt(pos.sideToMove);
+    gameOver = pos.gameOver;
+    winner = pos.winner >= 0 ? playerAt(pos.winner) : nullptr;
+    keyHistory.assign(1, currentKey());
+}
+
+template <int N, int Supply>
+inline uint64_t BasicBoop<N, Supply>::currentKey() const {
+    int gatitos[NUM_PLAYERS];
+    int gatos[NUM_PLAYERS];
+    gatitos[player1.index] = player1.gatitos_disponibles;
+    gatitos[player2.index] = player2.gatitos_disponibles;
+    gatos[player1.index] = player1.gatos_disponibles;
+    gatos[player2.index] = player2.gatos_disponibles;
+    return zobristKey(board.bits, gatitos, gatos, currentPlayer->index);
+}
+
+template <int N, int Supply>
+inline void BasicBoop<N, Supply>::displayGameState() const {
     cout << "\n==============================" << endl;
     cout << "Turno de: " << currentPlayer->name << " (" << currentPlayer->color << ")" << endl;
     cout << "Gatitos disponibles: " << currentPlayer->gatitos_disponibles << endl;
@@ -1,120 +1,22 @@
 #include "VenceJohnathan3000.h"
 #include "BoopGame.h"
+#include "BoopSearch.h"
+#include "BoopProtocol.h"
 
-// Implementación de métodos de Boop que no están inline en el header
+#include <cstdlib>
+#include <cstring>
 
-bool Boop::placePiece(int row, int col, PieceType pieceType) {
-    if (gameOver) {
-        std::cout << "El juego ha terminado!" << std::endl;
-        return false;
-    }
-
-    if (!board.isEmpty(row, col)) {
-        std::cout << "Esa posición ya está ocupada!" << std::endl;
-        return false;
-    }
-
-    if (pieceType == PieceType::GATITO && !currentPlayer->canPlaceGatito()) {
-        std::cout << "No tienes más gatitos disponibles!" << std::endl;
-        return false;
-    } else if (pieceType == PieceType::GATO && !currentPlayer->canPlaceGato()) {
-        std::cout << "No tienes gatos disponibles!" << std::endl;
-        return false;
-    }
-
-    Piece* piece;
-    if (pieceType == PieceType::GATITO) {
-        piece = new Gatito({row, col}, currentPlayer);
-        currentPlayer->useGatito();
-    } else {
-        piece = new Gato({row, col}, currentPlayer);
-        currentPlayer->useGato();
-    }
-
-    board.placePiece(piece, row, col);
-
-    std::vector<Piece*> boopedOut = board.boopPieces(row, col, piece);
-
-    for (Piece* boopedPiece : boopedOut) {
-        if (dynamic_cast<Gatito*>(boopedPiece)) {
-            boopedPiece->player->returnGatito();
-        } else {
-            boopedPiece->player->returnGato();
-        }
-        delete boopedPiece;
-    }
-
-    checkAndPromoteGatitos();
-    checkVictory();
-
-    if (!gameOver) {
-        switchPlayer();
-    }
-
-    return true;
-}
-
-void Boop::checkAndPromoteGatitos() {
-    Player* players[] = {&player1, &player2};
-    
-    for (Player* player : players) {
-        std::vector<std::vector<std::pair<int, int>>> lines = board.findLinesOfThree(player);
-        
-        for (const auto& line : lines) {
-            bool allGatitos = true;
-            for (const auto& pos : line) {
-                Piece* piece = board.getPiece(pos.first, pos.second);
-                if (!dynamic_cast<Gatito*>(piece)) {
-                    allGatitos = false;
-                    break;
-                }
-            }
-
-            if (allGatitos) {
-                for (const auto& pos : line) {
-                    Piece* piece = board.removePiece(pos.first, pos.second);
-                    delete piece;
-                }
-                player->promoteGatitosToGato(3);
-                std::cout << "¡" << player->name << " ha graduado a 3 gatitos!" << std::endl;
-            }
-        }
-    }
-}
-
-void Boop::checkVictory() {
-    Player* players[] = {&player1, &player2};
-    
-    for (Player* player : players) {
-        std::vector<std::vector<std::pair<int, int>>> lines = board.findLinesOfThree(player);
-        
-        for (const auto& line : lines) {
-            bool allGatos = true;
-            for (const auto& pos : line) {
-                Piece* piece = board.getPiece(pos.first, pos.second);
-                if (!dynamic_cast<Gato*>(piece)) {
-                    allGatos = false;
-                    break;
-                }
-            }
-
-            if (allGatos) {
-                gameOver = true;
-                winner = player;
-                std::cout << "¡" << player->name << " ha ganado con 3 gatos adultos en línea!" << std::endl;
-                return;
-            }
-        }
-    }
-}
+// Implementación de métodos de Boop que no están inline en el header.
+// La partida interactiva solo existe para el juego estándar (Boop)
 
+template <>
 std::tuple<int, int, PieceType> Boop::getPlayerInput() {
     while (true) {
         std::cout << "\n" << currentPlayer->name << ", es tu turno!" << std::endl;
         std::cout << "Ingresa tu movimiento en formato: fila,columna,tipo" << std::endl;
         std::cout << "Tipo: 'g' para gatito, 'G' para gato adulto" << std::endl;
         std::cout << "Ejemplo: 2,3,g" << std::endl;
-        std::cout << " la cantidad de posiciones del centro disponible: " << IsCenterAvailible(board.grid).size() << std::endl;
+        std::cout << " la cantidad de posiciones del centro disponible: " << IsCenterAvailible(board).size() << std::endl;
 
         std::cout << "Tu movimiento: ";
 
@@ -152,6 +54,7 @@ std::tuple<int, int, PieceType> Boop::getPlayerInput() {
     }
 }
 
+template <>
 void Boop::play() {
     std::cout << "¡Bienvenido al juego Boop!" << std::endl;
     std::cout << "Objetivo: Forma una línea de 3 gatos adultos para ganar" << std::endl;
@@ -161,6 +64,26 @@ void Boop::play() {
 
     while (!gameOver) {
         displayGameState();
+
+        Searcher* searcher = computerPlayers[currentPlayer->index];
+        if (searcher) {
+            SearchResult result = searcher->search(*this);
+            if (!result.hasMove) {
+                std::cout << currentPlayer->name << " no tiene jugadas posibles." << std::endl;
+                break;
+            }
+            Move move = result.bestMove;
+            std::cout << currentPlayer->name << " (computadora) juega: " << move.row() << "," << move.col() << ","
+                      << (move.type == PieceType::GATITO ? "g" : "G");
+            if (result.fromBook) {
+                std::cout << " (libro)" << std::endl;
+            } else {
+                std::cout << " (profundidad " << result.depth << ", evaluación " << result.score << ")" << std::endl;
+            }
+            placePiece(move.row(), move.col(), move.type);
+            continue;
+        }
+
         auto [row, col, pieceType] = getPlayerInput();
 
         if (!placePiece(row, col, pieceType)) {
@@ -177,8 +100,87 @@ void Boop::play() {
     board.display();
 }
 
-int main() {
+// Mide cómo escala la búsqueda con el número de hilos: para 1, 2, 4, ...
+// hilos imprime el tiempo hasta cada profundidad y los nodos por segundo
+void reportScaling(Searcher& searcher, int maxThreads) {
     Boop game;
+    int savedThreads = searcher.threads;
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        searcher.threads = threads;
+        searcher.table().clear();
+        searcher.onIteration = [threads](const SearchResult& result) {
+            std::cout << "hilos " << threads << "  profundidad " << result.depth
+                      << "  tiempo " << result.timeMs << " ms  nodos " << result.nodes
+                      << "  nps " << result.nps << std::endl;
+        };
+        SearchResult result = searcher.search(game);
+        std::cout << "hilos " << threads << "  total: profundidad " << result.depth << ", "
+                  << result.nodes << " nodos en " << result.timeMs << " ms (" << result.nps
+                  << " nodos/s)" << std::endl;
+    }
+
+    searcher.onIteration = nullptr;
+    searcher.threads = savedThreads;
+}
+
+// Opciones: --cpu1 / --cpu2 hacen que la computadora juegue ese asiento,
+// --profundidad N y --tiempo MS limitan cada búsqueda, --hilos N usa N hilos
+// y --escalado mide la búsqueda con 1, 2, 4, ... hasta N hilos.
+// --libro ARCHIVO juega las aperturas de un libro hecho con BoopBook.
+// --amenazas NODOS busca antes una victoria forzada por amenazas con ese
+// presupuesto de nodos.
+// --protocolo atiende el protocolo de texto de BoopProtocol.h en lugar de
+// la partida interactiva
+int main(int argc, char* argv[]) {
+    Boop game;
+    Searcher searcher;
+    searcher.limits.maxTimeMs = 2000;
+    bool scaling = false;
+    bool protocol = false;
+    OpeningBook book;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--cpu1") == 0) {
+            game.computerPlayers[0] = &searcher;
+        } else if (std::strcmp(argv[i], "--cpu2") == 0) {
+            game.computerPlayers[1] = &searcher;
+        } else if (std::strcmp(argv[i], "--profundidad") == 0 && i + 1 < argc) {
+            searcher.limits.maxDepth = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tiempo") == 0 && i + 1 < argc) {
+            searcher.limits.maxTimeMs = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--hilos") == 0 && i + 1 < argc) {
+            searcher.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--escalado") == 0) {
+            scaling = true;
+        } else if (std::strcmp(argv[i], "--protocolo") == 0) {
+            protocol = true;
+        } else if (std::strcmp(argv[i], "--amenazas") == 0 && i + 1 < argc) {
+            searcher.threatNodes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--libro") == 0 && i + 1 < argc) {
+            if (!book.open(argv[++i])) {
+                std::cerr << "No se pudo abrir el libro: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    if (scaling) {
+        reportScaling(searcher, searcher.threads > 1 ? searcher.threads : static_cast<int>(std::thread::hardware_concurrency()));
+        return 0;
+    }
+
+    // El escalado mide la búsqueda desde el inicio, así que no usa el libro
+    if (book.isOpen()) {
+        searcher.book = &book;
+    }
+
+    if (protocol) {
+        EngineProtocol engine(std::cin, std::cout, searcher);
+        engine.run();
+        return 0;
+    }
+
     game.play();
 
     return 0;
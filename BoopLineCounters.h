@@ -0,0 +1,163 @@
+#ifndef BOOPLINECOUNTERS_H
+#define BOOPLINECOUNTERS_H
+
+#include <cstdint>
+
+#include "BoopBitboard.h"
+
+// Contadores incrementales de las líneas de tres. Cada ventana de la tabla de
+// líneas guarda cuántas de sus casillas tiene cada (jugador, tipo) y cuántas
+// están ocupadas. Una pieza que se pone o se quita solo toca las líneas que
+// pasan por su casilla, así que las líneas completas y las de "dos de tres"
+// se consultan sin recorrer el tablero.
+
+// Como mucho 4 direcciones por 3 posiciones dentro de la ventana
+const int MAX_LINES_PER_SQUARE = 4 * LINE_LENGTH;
+
+// Líneas que pasan por cada casilla, en el orden de la tabla de líneas
+template <int N>
+struct SquareLineTable {
+    uint8_t count[N * N];
+    uint8_t lines[N * N][MAX_LINES_PER_SQUARE];
+};
+
+template <int N>
+constexpr SquareLineTable<N> makeSquareLineTable() {
+    SquareLineTable<N> table{};
+    for (int i = 0; i < BoardGeometry<N>::NUM_LINES; i++) {
+        for (int sq : LINE_TABLE<N>.squares[i]) {
+            table.lines[sq][table.count[sq]++] = static_cast<uint8_t>(i);
+        }
+    }
+    return table;
+}
+
+template <int N>
+inline constexpr SquareLineTable<N> SQUARE_LINES = makeSquareLineTable<N>();
+
+static_assert(SQUARE_LINES<BOARD_SIZE>.count[squareOf(2, 2)] == MAX_LINES_PER_SQUARE, "líneas por casilla");
+static_assert(SQUARE_LINES<BOARD_SIZE>.count[0] == 3, "líneas de la esquina");
+
+// Clase LineCounters
+template <int N>
+class BasicLineCounters {
+public:
+    static constexpr int NUM_LINES = BoardGeometry<N>::NUM_LINES;
+    // Palabras de 64 bits para un conjunto de líneas
+    static constexpr int LINE_WORDS = (NUM_LINES + 63) / 64;
+
+    void add(int player, int type, int sq);
+    void remove(int player, int type, int sq);
+
+    int count(int player, int type, int line) const { return counts[line][player * NUM_PIECE_TYPES + type]; }
+    int filled(int line) const { return counts[line][FILLED]; }
+    bool isComplete(int player, int type, int line) const {
+        return (completeLines(player, type)[line / 64] >> (line % 64)) & 1;
+    }
+    bool hasCompleteLine(int player, int type) const;
+    // Conjunto de líneas completas, un bit por índice de la tabla de líneas
+    const Bitboard* completeLines(int player, int type) const { return sets[1][player * NUM_PIECE_TYPES + type]; }
+    // Líneas con dos piezas de (jugador, tipo) y la tercera casilla vacía
+    int threatCount(int player, int type) const;
+    // Casillas vacías que completarían una de esas líneas
+    Bitboard threatSquares(int player, int type, Bitboard empty) const;
+
+private:
+    // Columna de counts con las casillas ocupadas de la línea
+    static constexpr int FILLED = NUM_PLAYERS * NUM_PIECE_TYPES;
+    // Estado de una línea: si todas sus piezas son de un mismo (jugador, tipo)
+    // y hay dos o tres, la línea está en uno de los conjuntos de abajo
+    static constexpr uint8_t NO_SET = 0;
+
+    uint8_t counts[NUM_LINES][FILLED + 1] = {};
+    // Conjunto en el que está cada línea: 1 + (piezas - 2) * FILLED + jugador * 2 + tipo
+    uint8_t state[NUM_LINES] = {};
+    // sets[0] son las líneas de dos de tres y sets[1] las completas
+    Bitboard sets[2][NUM_PLAYERS * NUM_PIECE_TYPES][LINE_WORDS] = {};
+
+    void refresh(int line);
+};
+
+using LineCounters = BasicLineCounters<BOARD_SIZE>;
+
+// Mueve la línea al conjunto que le toca según sus contadores. Una línea
+// está como mucho en un conjunto, así que basta con cambiar dos bits
+template <int N>
+inline void BasicLineCounters<N>::refresh(int line) {
+    const uint8_t* c = counts[line];
+    uint8_t next = NO_SET;
+    if (c[FILLED] >= LINE_LENGTH - 1) {
+        for (int pt = 0; pt < FILLED; pt++) {
+            if (c[pt] == c[FILLED]) {
+                next = static_cast<uint8_t>(1 + (c[FILLED] - (LINE_LENGTH - 1)) * FILLED + pt);
+            }
+        }
+    }
+    if (next == state[line]) {
+        return;
+    }
+
+    const int word = line / 64;
+    const Bitboard bit = squareBit(line % 64);
+    if (state[line] != NO_SET) {
+        sets[(state[line] - 1) / FILLED][(state[line] - 1) % FILLED][word] &= ~bit;
+    }
+    if (next != NO_SET) {
+        sets[(next - 1) / FILLED][(next - 1) % FILLED][word] |= bit;
+    }
+    state[line] = next;
+}
+
+template <int N>
+inline void BasicLineCounters<N>::add(int player, int type, int sq) {
+    const SquareLineTable<N>& table = SQUARE_LINES<N>;
+    for (int i = 0; i < table.count[sq]; i++) {
+        int line = table.lines[sq][i];
+        counts[line][player * NUM_PIECE_TYPES + type]++;
+        counts[line][FILLED]++;
+        refresh(line);
+    }
+}
+
+template <int N>
+inline void BasicLineCounters<N>::remove(int player, int type, int sq) {
+    const SquareLineTable<N>& table = SQUARE_LINES<N>;
+    for (int i = 0; i < table.count[sq]; i++) {
+        int line = table.lines[sq][i];
+        counts[line][player * NUM_PIECE_TYPES + type]--;
+        counts[line][FILLED]--;
+        refresh(line);
+    }
+}
+
+template <int N>
+inline bool BasicLineCounters<N>::hasCompleteLine(int player, int type) const {
+    Bitboard any = 0;
+    for (int w = 0; w < LINE_WORDS; w++) {
+        any |= completeLines(player, type)[w];
+    }
+    return any != 0;
+}
+
+template <int N>
+inline int BasicLineCounters<N>::threatCount(int player, int type) const {
+    int total = 0;
+    for (int w = 0; w < LINE_WORDS; w++) {
+        total += popCount(sets[0][player * NUM_PIECE_TYPES + type][w]);
+    }
+    return total;
+}
+
+template <int N>
+inline Bitboard BasicLineCounters<N>::threatSquares(int player, int type, Bitboard empty) const {
+    Bitboard squares = 0;
+    for (int w = 0; w < LINE_WORDS; w++) {
+        Bitboard lines = sets[0][player * NUM_PIECE_TYPES + type][w];
+        while (lines) {
+            squares |= LINE_TABLE<N>.mask[w * 64 + popLsb(lines)] & empty;
+        }
+    }
+    return squares;
+}
+
+#endif // BOOPLINECOUNTERS_H
@@ -0,0 +1,428 @@
+#ifndef BOOPMCTS_H
+#define BOOPMCTS_H
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "BoopGame.h"
+#include "BoopMoveGen.h"
+
+// Motor de búsqueda Monte Carlo (UCT) para Boop.
+// Los nodos viven en un pool preasignado; los hijos de un nodo ocupan un
+// bloque contiguo. Varios hilos comparten el árbol usando pérdida virtual,
+// y entre jugadas de una misma partida se reutiliza el subárbol de la
+// posición alcanzada. Las simulaciones usan Position::makeMove/unmakeMove,
+// sin asignaciones ni salida por pantalla.
+
+const int MCTS_MAX_PLAYOUT_PLIES = 200;
+const int32_t MCTS_NO_NODE = -1;
+
+// Límites de una búsqueda MCTS; 0 significa sin límite (al menos uno debe fijarse)
+struct MCTSLimits {
+    int64_t maxPlayouts = 10000;
+    int64_t maxTimeMs = 0;
+};
+
+struct MCTSResult {
+    Move bestMove;
+    bool hasMove = false;
+    int64_t playouts = 0;
+    // Fracción de victorias de la jugada elegida, tablas cuentan 0.5
+    double winRate = 0.0;
+    int64_t timeMs = 0;
+    size_t nodesUsed = 0;
+};
+
+// Nodo del árbol. El resultado se acumula desde el punto de vista del
+// jugador que hizo la jugada que lleva a este nodo: 2 por victoria, 1 por tablas
+struct MCTSNode {
+    Move move;
+    int32_t firstChild = MCTS_NO_NODE;
+    int32_t childCount = 0;
+    std::atomic<int32_t> visits{0};
+    std::atomic<int32_t> virtualLoss{0};
+    std::atomic<int64_t> score{0};
+    // 0 sin expandir, 1 expandiéndose, 2 expandido, 3 hoja fija (sin
+    // jugadas o sin espacio en el pool; no se vuelve a intentar)
+    std::atomic<uint8_t> state{0};
+};
+
+// Pool de nodos de capacidad fija con reserva atómica de bloques
+class MCTSNodePool {
+public:
+    explicit MCTSNodePool(size_t capacity);
+    int32_t allocate(int32_t count);
+    void reset() { used = 0; }
+    size_t size() const { return used.load(); }
+    size_t capacity() const { return nodeCapacity; }
+    MCTSNode& operator[](int32_t index) { return nodes[index]; }
+    const MCTSNode& operator[](int32_t index) const { return nodes[index]; }
+
+private:
+    std::unique_ptr<MCTSNode[]> nodes;
+    size_t nodeCapacity;
+    std::atomic<size_t> used{0};
+};
+
+inline MCTSNodePool::MCTSNodePool(size_t capacity) : nodes(new MCTSNode[capacity]), nodeCapacity(capacity) {}
+
+// Retorna el índice del primer nodo del bloque, o MCTS_NO_NODE si no cabe.
+// Un bloque que no cabe no reserva nada: el resto del pool sigue libre para
+// bloques más chicos
+inline int32_t MCTSNodePool::allocate(int32_t count) {
+    size_t start = used.load(std::memory_order_relaxed);
+    do {
+        if (start + count > nodeCapacity) {
+            return MCTS_NO_NODE;
+        }
+    } while (!used.compare_exchange_weak(start, start + count));
+    for (int32_t i = 0; i < count; i++) {
+        MCTSNode& node = nodes[start + i];
+        node.firstChild = MCTS_NO_NODE;
+        node.childCount = 0;
+        node.visits.store(0, std::memory_order_relaxed);
+        node.virtualLoss.store(0, std::memory_order_relaxed);
+        node.score.store(0, std::memory_order_relaxed);
+        node.state.store(0, std::memory_order_relaxed);
+    }
+    return static_cast<int32_t>(start);
+}
+
+// Clase MCTS
+class MCTS {
+public:
+    MCTSLimits limits;
+    int threads = 1;
+    double exploration = 1.4;
+    uint64_t seed = 1;
+
+    explicit MCTS(size_t maxNodes = 1 << 20);
+    MCTSResult search(const Boop& game);
+    MCTSResult search(const Position& pos);
+    // Reutiliza el subárbol de la jugada indicada como nueva raíz
+    void advance(const Move& move);
+    void reset();
+
+private:
+    std::unique_ptr<MCTSNodePool> pool;
+    std::unique_ptr<MCTSNodePool> spare;
+    int32_t root = MCTS_NO_NODE;
+    Position rootPos;
+    std::atomic<int64_t> playoutsDone{0};
+    std::atomic<bool> stopRequested{false};
+    std::chrono::steady_clock::time_point startTime;
+
+    void worker(int id);
+    void runIteration(Position& pos, std::mt19937_64& rng);
+    bool expand(int32_t node, const Position& pos);
+    int32_t selectChild(int32_t node) const;
+    int playout(Position& pos, std::mt19937_64& rng) const;
+    bool reuseSubtree(const Position& pos);
+    int32_t copySubtree(int32_t node, MCTSNodePool& target, int32_t targetIndex) const;
+    bool budgetExhausted() const;
+};
+
+inline MCTS::MCTS(size_t maxNodes)
+    : pool(new MCTSNodePool(maxNodes)), spare(new MCTSNodePool(maxNodes)) {}
+
+inline void MCTS::reset() {
+    pool->reset();
+    root = pool->allocate(1);
+    rootPos = Position();
+}
+
+inline MCTSResult MCTS::search(const Boop& game) {
+    return search(game.position());
+}
+
+inline MCTSResult MCTS::search(const Position& pos) {
+    MCTSResult result;
+    startTime = std::chrono::steady_clock::now();
+    MetricTimer decisionTimer(MetricHistogram::DECISION_MICROS);
+
+    // Una raíz que quedó como hoja fija no se pudo expandir con el pool lleno
+    if (!reuseSubtree(pos) || (*pool)[root].state == 3) {
+        pool->reset();
+        root = pool->allocate(1);
+        rootPos = pos;
+        rootPos.clearHistory();
+    }
+    if (pos.gameOver || !expand(root, rootPos)) {
+        decisionTimer.cancel();
+        return result;
+    }
+
+    playoutsDone = 0;
+    stopRequested = false;
+    int threadCount = threads > 1 ? threads : 1;
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threadCount; i++) {
+        helpers.emplace_back([this, i] { worker(i); });
+    }
+    worker(0);
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    // La jugada más visitada es la más robusta
+    const MCTSNode& rootNode = (*pool)[root];
+    int32_t best = rootNode.firstChild;
+    for (int32_t i = 0; i < rootNode.childCount; i++) {
+        int32_t child = rootNode.firstChild + i;
+        if ((*pool)[child].visits > (*pool)[best].visits) {
+            best = child;
+        }
+    }
+
+    const MCTSNode& bestNode = (*pool)[best];
+    result.bestMove = bestNode.move;
+    result.hasMove = true;
+    result.playouts = playoutsDone;
+    result.winRate = bestNode.visits > 0 ? bestNode.score / (2.0 * bestNode.visits) : 0.0;
+    result.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    result.nodesUsed = pool->size();
+    countMetric(MetricCounter::DECISIONS);
+    return result;
+}
+
+inline void MCTS::worker(int id) {
+    std::mt19937_64 rng(seed * 0x9E3779B97F4A7C15ULL + id);
+    Position pos = rootPos;
+    while (!budgetExhausted()) {
+        runIteration(pos, rng);
+        playoutsDone++;
+    }
+    stopRequested = true;
+}
+
+// Una iteración: selección con pérdida virtual, expansión, simulación y
+// propagación del resultado hacia la raíz
+inline void MCTS::runIteration(Position& pos, std::mt19937_64& rng) {
+    int32_t path[MAX_PLY];
+    int movers[MAX_PLY];
+    int length = 0;
+    int32_t node = root;
+    int limit = MAX_PLY - MCTS_MAX_PLAYOUT_PLIES - 1;
+
+    while ((*pool)[node].state.load(std::memory_order_acquire) == 2 && !pos.gameOver && length < limit) {
+        int32_t child = selectChild(node);
+        if (child == MCTS_NO_NODE) {
+            break;
+        }
+        (*pool)[child].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+        movers[length] = pos.sideToMove;
+        path[length++] = child;
+        pos.makeMove((*pool)[child].move);
+        node = child;
+    }
+
+    if (!pos.gameOver && (*pool)[node].visits > 0) {
+        expand(node, pos);
+    }
+
+    int winner = pos.gameOver ? pos.winner : playout(pos, rng);
+
+    for (int i = length - 1; i >= 0; i--) {
+        MCTSNode& step = (*pool)[path[i]];
+        int points = winner < 0 ? 1 : (winner == movers[i] ? 2 : 0);
+        step.score.fetch_add(points, std::memory_order_relaxed);
+        step.visits.fetch_add(1, std::memory_order_relaxed);
+        step.virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+        pos.unmakeMove();
+    }
+    (*pool)[root].visits.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Crea los hijos de un nodo; solo un hilo gana el derecho a expandirlo
+inline bool MCTS::expand(int32_t node, const Position& pos) {
+    MCTSNode& parent = (*pool)[node];
+    uint8_t expected = 0;
+    if (!parent.state.compare_exchange_strong(expected, 1)) {
+        return expected == 2 && parent.childCount > 0;
+    }
+
+    MoveList moves;
+    generateMoves(pos, moves);
+    int count = moves.size();
+    int32_t first = count > 0 ? pool->allocate(count) : MCTS_NO_NODE;
+    if (first == MCTS_NO_NODE) {
+        // Sin jugadas o sin espacio en el pool: el nodo queda como hoja y
+        // las visitas siguientes no vuelven a generar sus jugadas
+        parent.state.store(3, std::memory_order_release);
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        (*pool)[first + i].move = moves[i];
+    }
+    parent.firstChild = first;
+    parent.childCount = count;
+    parent.state.store(2, std::memory_order_release);
+    return true;
+}
+
+// UCT: media de resultados más término de exploración. La pérdida virtual
+// cuenta como visitas perdidas para alejar a otros hilos del mismo camino
+inline int32_t MCTS::selectChild(int32_t node) const {
+    const MCTSNode& parent = (*pool)[node];
+    double logVisits = std::log(static_cast<double>(parent.visits.load(std::memory_order_relaxed)) + 1.0);
+    int32_t best = MCTS_NO_NODE;
+    double bestValue = -1.0;
+
+    for (int32_t i = 0; i < parent.childCount; i++) {
+        int32_t child = parent.firstChild + i;
+        const MCTSNode& candidate = (*pool)[child];
+        int32_t visits = candidate.visits.load(std::memory_order_relaxed) +
+                         candidate.virtualLoss.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            return child;
+        }
+        double mean = candidate.score.load(std::memory_order_relaxed) / (2.0 * visits);
+        double value = mean + exploration * std::sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = child;
+        }
+    }
+    return best;
+}
+
+// Simulación con jugadas al azar; deja la posición como estaba y retorna el
+// ganador (-1 si se llega al límite o no quedan jugadas)
+inline int MCTS::playout(Position& pos, std::mt19937_64& rng) const {
+    MoveList moves;
+    int plies = 0;
+    while (!pos.gameOver && plies < MCTS_MAX_PLAYOUT_PLIES) {
+        generateMoves(pos, moves);
+        if (moves.empty()) {
+            break;
+        }
+        pos.makeMove(moves[rng() % moves.size()]);
+        plies++;
+    }
+
+    int winner = pos.gameOver ? pos.winner : -1;
+    while (plies-- > 0) {
+        pos.unmakeMove();
+    }
+    return winner;
+}
+
+inline void MCTS::advance(const Move& move) {
+    if (root == MCTS_NO_NODE || !rootPos.isLegal(move)) {
+        reset();
+        return;
+    }
+
+    const MCTSNode& rootNode = (*pool)[root];
+    int32_t next = MCTS_NO_NODE;
+    if (rootNode.state == 2) {
+        for (int32_t i = 0; i < rootNode.childCount; i++) {
+            if ((*pool)[rootNode.firstChild + i].move == move) {
+                next = rootNode.firstChild + i;
+            }
+        }
+    }
+
+    rootPos.makeMove(move);
+    rootPos.clearHistory();
+    if (next == MCTS_NO_NODE) {
+        pool->reset();
+        root = pool->allocate(1);
+    } else {
+        // Se compacta el subárbol en el pool de repuesto y se intercambian
+        spare->reset();
+        int32_t newRoot = spare->allocate(1);
+        copySubtree(next, *spare, newRoot);
+        std::swap(pool, spare);
+        root = newRoot;
+    }
+}
+
+// Busca la posición entre la raíz actual y sus nietos (nuestra jugada y la
+// respuesta del rival) y, si aparece, la convierte en la nueva raíz
+inline bool MCTS::reuseSubtree(const Position& pos) {
+    if (root == MCTS_NO_NODE) {
+        return false;
+    }
+    if (rootPos.key == pos.key) {
+        return true;
+    }
+
+    const MCTSNode& rootNode = (*pool)[root];
+    if (rootNode.state != 2) {
+        return false;
+    }
+    for (int32_t i = 0; i < rootNode.childCount; i++) {
+        const MCTSNode& child = (*pool)[rootNode.firstChild + i];
+        const Move move = child.move;
+        rootPos.makeMove(move);
+        if (rootPos.key == pos.key) {
+            rootPos.unmakeMove();
+            advance(move);
+            return true;
+        }
+        if (child.state == 2 && !rootPos.gameOver) {
+            for (int32_t j = 0; j < child.childCount; j++) {
+                const Move reply = (*pool)[child.firstChild + j].move;
+                rootPos.makeMove(reply);
+                bool found = rootPos.key == pos.key;
+                rootPos.unmakeMove();
+                if (found) {
+                    rootPos.unmakeMove();
+                    advance(move);
+                    advance(reply);
+                    return true;
+                }
+            }
+        }
+        rootPos.unmakeMove();
+    }
+    return false;
+}
+
+// Copia en profundidad las estadísticas y los hijos expandidos de un nodo
+inline int32_t MCTS::copySubtree(int32_t node, MCTSNodePool& target, int32_t targetIndex) const {
+    const MCTSNode& source = (*pool)[node];
+    MCTSNode& copy = target[targetIndex];
+    copy.move = source.move;
+    copy.visits.store(source.visits.load());
+    copy.score.store(source.score.load());
+
+    if (source.state == 2) {
+        int32_t first = target.allocate(source.childCount);
+        if (first != MCTS_NO_NODE) {
+            copy.firstChild = first;
+            copy.childCount = source.childCount;
+            for (int32_t i = 0; i < source.childCount; i++) {
+                copySubtree(source.firstChild + i, target, first + i);
+            }
+            copy.state.store(2);
+        }
+    }
+    return targetIndex;
+}
+
+inline bool MCTS::budgetExhausted() const {
+    if (stopRequested) {
+        return true;
+    }
+    if (limits.maxPlayouts > 0 && playoutsDone >= limits.maxPlayouts) {
+        return true;
+    }
+    if (limits.maxTimeMs > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+        return elapsed >= limits.maxTimeMs;
+    }
+    return false;
+}
+
+#endif // BOOPMCTS_H
@@ -0,0 +1,509 @@
+#ifndef BOOPMETRICS_H
+#define BOOPMETRICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Métricas del núcleo de reglas y de los motores: contadores e histogramas
+// de latencia. Cada hilo escribe en su propio bloque, sin operaciones
+// atómicas de lectura-modificación-escritura ni candados; una instantánea
+// suma los bloques vivos y los de los hilos que ya terminaron.
+//
+// Los histogramas son logarítmico-lineales, como HDR: cada potencia de dos
+// se parte en 16 cubetas, así que un valor se guarda con un error relativo
+// menor al 6% y un histograma cubre de 0 a 2^64 con 976 cubetas.
+//
+// Compilar con -DBOOP_METRICS=0 quita todo: las funciones de medición quedan
+// vacías y el compilador las elimina.
+
+#ifndef BOOP_METRICS
+#define BOOP_METRICS 1
+#endif
+
+enum class MetricCounter {
+    MOVES,             // jugadas aplicadas con placePiece o en BoopSelfPlay
+    REJECTED_MOVES,    // jugadas rechazadas por placePiece
+    BOOPING_MOVES,     // jugadas cuyo boop movió o expulsó algún gatito
+    PIECES_BOOPED,     // gatitos empujados dentro del tablero
+    BOOP_OUTS,         // gatitos expulsados del tablero
+    GRADUATIONS,       // líneas de gatitos graduadas
+    LINE_SCANS,        // llamadas a findLinesOfThree
+    WINS,              // partidas ganadas con tres gatos
+    DECISIONS,         // jugadas elegidas por un motor
+    BOOK_DECISIONS,    // de ellas, salidas del libro
+    SEARCH_NODES,      // nodos de Searcher
+    SEARCH_MICROS,     // tiempo de Searcher, en microsegundos
+    TT_PROBES,         // consultas a la tabla de transposición
+    TT_HITS,           // consultas que encontraron la posición
+    COUNT
+};
+
+enum class MetricHistogram {
+    DECISION_MICROS,      // tiempo de cada decisión de un motor
+    BOOPS_PER_MOVE,       // gatitos movidos o expulsados por el boop de una jugada
+    BOOP_OUTS_PER_MOVE,   // gatitos expulsados por jugada
+    GRADUATIONS_PER_MOVE, // líneas graduadas por jugada
+    SEARCH_NPS,           // nodos por segundo de cada búsqueda
+    COUNT
+};
+
+const int NUM_METRIC_COUNTERS = static_cast<int>(MetricCounter::COUNT);
+const int NUM_METRIC_HISTOGRAMS = static_cast<int>(MetricHistogram::COUNT);
+
+// Nombre para la exportación y descripción de cada métrica
+const char* const METRIC_COUNTER_NAMES[NUM_METRIC_COUNTERS][2] = {
+    {"boop_moves_total", "Jugadas aplicadas"},
+    {"boop_rejected_moves_total", "Jugadas rechazadas"},
+    {"boop_booping_moves_total", "Jugadas cuyo boop movio o expulso algun gatito"},
+    {"boop_pieces_booped_total", "Gatitos empujados dentro del tablero"},
+    {"boop_boop_outs_total", "Gatitos expulsados del tablero"},
+    {"boop_graduations_total", "Lineas de gatitos graduadas"},
+    {"boop_line_scans_total", "Llamadas a findLinesOfThree"},
+    {"boop_wins_total", "Partidas ganadas"},
+    {"boop_decisions_total", "Jugadas elegidas por un motor"},
+    {"boop_book_decisions_total", "Jugadas elegidas del libro"},
+    {"boop_search_nodes_total", "Nodos de busqueda"},
+    {"boop_search_micros_total", "Tiempo de busqueda en microsegundos"},
+    {"boop_tt_probes_total", "Consultas a la tabla de transposicion"},
+    {"boop_tt_hits_total", "Consultas a la tabla que encontraron la posicion"},
+};
+
+const char* const METRIC_HISTOGRAM_NAMES[NUM_METRIC_HISTOGRAMS][2] = {
+    {"boop_decision_micros", "Tiempo de cada decision en microsegundos"},
+    {"boop_boops_per_move", "Gatitos movidos o expulsados por jugada"},
+    {"boop_boop_outs_per_move", "Gatitos expulsados por jugada"},
+    {"boop_graduations_per_move", "Lineas graduadas por jugada"},
+    {"boop_search_nps", "Nodos por segundo de cada busqueda"},
+};
+
+// Cubetas de un histograma: 32 exactas para 0..31 y 16 por cada potencia de
+// dos desde 2^5
+const int METRIC_SUB_BUCKET_BITS = 4;
+const int METRIC_SUB_BUCKETS = 1 << METRIC_SUB_BUCKET_BITS;
+const int METRIC_BUCKETS = 2 * METRIC_SUB_BUCKETS + (64 - METRIC_SUB_BUCKET_BITS - 1) * METRIC_SUB_BUCKETS;
+
+constexpr int metricBucket(uint64_t value) {
+    if (value < 2 * METRIC_SUB_BUCKETS) {
+        return static_cast<int>(value);
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    int shift = exponent - METRIC_SUB_BUCKET_BITS;
+    return 2 * METRIC_SUB_BUCKETS + (shift - 1) * METRIC_SUB_BUCKETS +
+           static_cast<int>((value >> shift) - METRIC_SUB_BUCKETS);
+}
+
+// Menor valor que cae en la cubeta
+constexpr uint64_t metricBucketLow(int bucket) {
+    if (bucket < 2 * METRIC_SUB_BUCKETS) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int shift = (bucket - 2 * METRIC_SUB_BUCKETS) / METRIC_SUB_BUCKETS + 1;
+    uint64_t mantissa = METRIC_SUB_BUCKETS + (bucket - 2 * METRIC_SUB_BUCKETS) % METRIC_SUB_BUCKETS;
+    return mantissa << shift;
+}
+
+static_assert(metricBucket(31) == 31 && metricBucket(32) == 32 && metricBucket(34) == 33, "cubetas bajas");
+static_assert(metricBucket(UINT64_MAX) == METRIC_BUCKETS - 1, "última cubeta");
+static_assert(metricBucketLow(metricBucket(1000)) <= 1000 && metricBucketLow(metricBucket(1000) + 1) > 1000,
+              "límite de cubeta");
+
+// Histograma ya sumado, para consultar y exportar
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    uint64_t buckets[METRIC_BUCKETS] = {};
+
+    // Valor del cuantil q (0..1): el menor valor de su cubeta, acotado por el máximo
+    uint64_t quantile(double q) const {
+        if (count == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(q * (count - 1)) + 1;
+        uint64_t seen = 0;
+        for (int b = 0; b < METRIC_BUCKETS; b++) {
+            seen += buckets[b];
+            if (seen >= rank) {
+                return metricBucketLow(b) < max ? metricBucketLow(b) : max;
+            }
+        }
+        return max;
+    }
+    double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+};
+
+struct MetricsSnapshot {
+    uint64_t counters[NUM_METRIC_COUNTERS] = {};
+    HistogramSnapshot histograms[NUM_METRIC_HISTOGRAMS];
+    // Hilos que escribieron métricas, vivos o terminados
+    int threads = 0;
+
+    uint64_t counter(MetricCounter c) const { return counters[static_cast<int>(c)]; }
+    const HistogramSnapshot& histogram(MetricHistogram h) const { return histograms[static_cast<int>(h)]; }
+    double ttHitRate() const {
+        uint64_t probes = counter(MetricCounter::TT_PROBES);
+        return probes ? static_cast<double>(counter(MetricCounter::TT_HITS)) / probes : 0.0;
+    }
+    double nodesPerSecond() const {
+        uint64_t micros = counter(MetricCounter::SEARCH_MICROS);
+        return micros ? counter(MetricCounter::SEARCH_NODES) * 1e6 / micros : 0.0;
+    }
+};
+
+// Bloque de métricas de un hilo. Solo su hilo escribe; los valores son
+// atómicos para que la instantánea los lea sin carrera, pero se actualizan
+// con load y store relajados, que cuestan lo mismo que una suma normal
+struct MetricShard {
+    struct Histogram {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+        std::atomic<uint64_t> buckets[METRIC_BUCKETS] = {};
+    };
+
+    std::atomic<uint64_t> counters[NUM_METRIC_COUNTERS] = {};
+    Histogram histograms[NUM_METRIC_HISTOGRAMS];
+
+    static void bump(std::atomic<uint64_t>& value, uint64_t amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void add(MetricCounter c, uint64_t amount) { bump(counters[static_cast<int>(c)], amount); }
+
+    void record(MetricHistogram h, uint64_t value) {
+        Histogram& histogram = histograms[static_cast<int>(h)];
+        bump(histogram.count, 1);
+        bump(histogram.sum, value);
+        if (value > histogram.max.load(std::memory_order_relaxed)) {
+            histogram.max.store(value, std::memory_order_relaxed);
+        }
+        bump(histogram.buckets[metricBucket(value)], 1);
+    }
+
+    void addTo(MetricsSnapshot& snapshot) const {
+        for (int c = 0; c < NUM_METRIC_COUNTERS; c++) {
+            snapshot.counters[c] += counters[c].load(std::memory_order_relaxed);
+        }
+        for (int h = 0; h < NUM_METRIC_HISTOGRAMS; h++) {
+            const Histogram& from = histograms[h];
+            HistogramSnapshot& to = snapshot.histograms[h];
+            to.count += from.count.load(std::memory_order_relaxed);
+            to.sum += from.sum.load(std::memory_order_relaxed);
+            uint64_t max = from.max.load(std::memory_order_relaxed);
+            to.max = max > to.max ? max : to.max;
+            for (int b = 0; b < METRIC_BUCKETS; b++) {
+                to.buckets[b] += from.buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// Registro de los bloques de todos los hilos
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance() {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    MetricShard* attach() {
+        std::lock_guard<std::mutex> lock(guard);
+        shards.push_back(new MetricShard());
+        return shards.back();
+    }
+
+    // El hilo terminó: su bloque se suma a los retirados y se libera
+    void detach(MetricShard* shard) {
+        std::lock_guard<std::mutex> lock(guard);
+        shard->addTo(retired);
+        retiredThreads++;
+        shards.erase(std::find(shards.begin(), shards.end(), shard));
+        delete shard;
+    }
+
+    MetricsSnapshot snapshot() {
+        std::lock_guard<std::mutex> lock(guard);
+        MetricsSnapshot result = retired;
+        for (const MetricShard* shard : shards) {
+            shard->addTo(result);
+        }
+        result.threads = retiredThreads + static_cast<int>(shards.size());
+        return result;
+    }
+
+private:
+    std::mutex guard;
+    std::vector<MetricShard*> shards;
+    MetricsSnapshot retired;
+    int retiredThreads = 0;
+};
+
+// Dueño del bloque del hilo: lo registra al primer uso y lo retira al salir
+struct MetricShardOwner {
+    MetricShard* shard = nullptr;
+    ~MetricShardOwner() {
+        if (shard) {
+            MetricsRegistry::instance().detach(shard);
+        }
+    }
+};
+
+inline thread_local MetricShardOwner metricShardOwner;
+// Copia sin destructor del puntero, para que el camino rápido no pase por
+// la inicialización del thread_local con destructor
+inline thread_local MetricShard* metricShard = nullptr;
+
+inline MetricShard& localMetrics() {
+    if (!metricShard) {
+        metricShard = metricShardOwner.shard = MetricsRegistry::instance().attach();
+    }
+    return *metricShard;
+}
+
+inline void countMetric(MetricCounter c, uint64_t amount = 1) {
+#if BOOP_METRICS
+    localMetrics().add(c, amount);
+#else
+    (void)c;
+    (void)amount;
+#endif
+}
+
+inline void recordMetric(MetricHistogram h, uint64_t value) {
+#if BOOP_METRICS
+    localMetrics().record(h, value);
+#else
+    (void)h;
+    (void)value;
+#endif
+}
+
+// Mide en microsegundos desde su creación hasta stop() o su destrucción
+class MetricTimer {
+public:
+    explicit MetricTimer(MetricHistogram histogram) : histogram(histogram) {
+#if BOOP_METRICS
+        start = std::chrono::steady_clock::now();
+#endif
+    }
+    ~MetricTimer() { stop(); }
+    MetricTimer(const MetricTimer&) = delete;
+    MetricTimer& operator=(const MetricTimer&) = delete;
+
+    // Descarta la medición
+    void cancel() {
+#if BOOP_METRICS
+        stopped = true;
+#endif
+    }
+
+    void stop() {
+#if BOOP_METRICS
+        if (!stopped) {
+            stopped = true;
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            recordMetric(histogram, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        }
+#endif
+    }
+
+private:
+    MetricHistogram histogram;
+#if BOOP_METRICS
+    std::chrono::steady_clock::time_point start;
+    bool stopped = false;
+#endif
+};
+
+#if BOOP_METRICS
+inline void addMoveMetrics(MetricShard& shard, int pushed, int out, int graduated, bool won) {
+    shard.add(MetricCounter::MOVES, 1);
+    shard.add(MetricCounter::BOOPING_MOVES, pushed + out > 0);
+    shard.add(MetricCounter::PIECES_BOOPED, pushed);
+    shard.add(MetricCounter::BOOP_OUTS, out);
+    shard.add(MetricCounter::GRADUATIONS, graduated);
+    shard.record(MetricHistogram::BOOPS_PER_MOVE, pushed + out);
+    shard.record(MetricHistogram::BOOP_OUTS_PER_MOVE, out);
+    shard.record(MetricHistogram::GRADUATIONS_PER_MOVE, graduated);
+    if (won) {
+        shard.add(MetricCounter::WINS, 1);
+    }
+}
+#endif
+
+// Cuenta una jugada de Boop::placePiece con todo lo que hizo. Las reglas
+// avisan una sola vez por jugada, no en cada boop o graduación, para que
+// boopPieces y las demás funciones del camino de la jugada no paguen nada
+inline void countPlacedMove(int pushed, int out, int graduated, bool won) {
+#if BOOP_METRICS
+    addMoveMetrics(localMetrics(), pushed, out, graduated, won);
+#else
+    (void)pushed;
+    (void)out;
+    (void)graduated;
+    (void)won;
+#endif
+}
+
+// Cuenta una jugada de la partida aplicada con Position::makeMove, a partir
+// de su información de deshacer. Las jugadas de la búsqueda no se cuentan:
+// son hipotéticas y medirlas costaría en cada nodo
+template <class Undo>
+inline void countPlayedMove(const Undo& undo, bool won) {
+#if BOOP_METRICS
+    addMoveMetrics(localMetrics(), undo.boop.pushedCount, undo.boop.outCount, undo.graduatedCount, won);
+#else
+    (void)undo;
+    (void)won;
+#endif
+}
+
+inline MetricsSnapshot metricsSnapshot() {
+#if BOOP_METRICS
+    return MetricsRegistry::instance().snapshot();
+#else
+    return MetricsSnapshot();
+#endif
+}
+
+enum class MetricsFormat {
+    JSON,
+    PROMETHEUS
+};
+
+// Cuantiles que se exportan de cada histograma
+const double METRIC_QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+// Objeto JSON en una sola línea
+inline std::string metricsToJson(const MetricsSnapshot& snapshot) {
+    std::ostringstream out;
+    out << "{\"threads\":" << snapshot.threads << ",\"counters\":{";
+    for (int c = 0; c < NUM_METRIC_COUNTERS; c++) {
+        out << (c ? "," : "") << "\"" << METRIC_COUNTER_NAMES[c][0] << "\":" << snapshot.counters[c];
+    }
+    out << "},\"tt_hit_rate\":" << snapshot.ttHitRate() << ",\"nodes_per_second\":" << snapshot.nodesPerSecond()
+        << ",\"histograms\":{";
+    for (int h = 0; h < NUM_METRIC_HISTOGRAMS; h++) {
+        const HistogramSnapshot& histogram = snapshot.histograms[h];
+        out << (h ? "," : "") << "\"" << METRIC_HISTOGRAM_NAMES[h][0] << "\":{\"count\":" << histogram.count
+            << ",\"sum\":" << histogram.sum << ",\"mean\":" << histogram.mean() << ",\"max\":" << histogram.max;
+        for (double q : METRIC_QUANTILES) {
+            out << ",\"p" << q * 100 << "\":" << histogram.quantile(q);
+        }
+        out << "}";
+    }
+    out << "}}\n";
+    return out.str();
+}
+
+// Formato de texto de Prometheus: contadores, dos medidas derivadas y los
+// histogramas como resúmenes con cuantiles
+inline std::string metricsToPrometheus(const MetricsSnapshot& snapshot) {
+    std::ostringstream out;
+    for (int c = 0; c < NUM_METRIC_COUNTERS; c++) {
+        out << "# HELP " << METRIC_COUNTER_NAMES[c][0] << " " << METRIC_COUNTER_NAMES[c][1] << "\n";
+        out << "# TYPE " << METRIC_COUNTER_NAMES[c][0] << " counter\n";
+        out << METRIC_COUNTER_NAMES[c][0] << " " << snapshot.counters[c] << "\n";
+    }
+    out << "# HELP boop_tt_hit_rate Fraccion de consultas a la tabla que encontraron la posicion\n"
+        << "# TYPE boop_tt_hit_rate gauge\n"
+        << "boop_tt_hit_rate " << snapshot.ttHitRate() << "\n";
+    out << "# HELP boop_nodes_per_second Nodos por segundo de todas las busquedas\n"
+        << "# TYPE boop_nodes_per_second gauge\n"
+        << "boop_nodes_per_second " << snapshot.nodesPerSecond() << "\n";
+    out << "# HELP boop_threads Hilos que escribieron metricas\n"
+        << "# TYPE boop_threads gauge\n"
+        << "boop_threads " << snapshot.threads << "\n";
+    for (int h = 0; h < NUM_METRIC_HISTOGRAMS; h++) {
+        const HistogramSnapshot& histogram = snapshot.histograms[h];
+        const char* name = METRIC_HISTOGRAM_NAMES[h][0];
+        out << "# HELP " << name << " " << METRIC_HISTOGRAM_NAMES[h][1] << "\n";
+        out << "# TYPE " << name << " summary\n";
+        for (double q : METRIC_QUANTILES) {
+            out << name << "{quantile=\"" << q << "\"} " << histogram.quantile(q) << "\n";
+        }
+        out << name << "_sum " << histogram.sum << "\n";
+        out << name << "_count " << histogram.count << "\n";
+    }
+    return out.str();
+}
+
+inline std::string formatMetrics(const MetricsSnapshot& snapshot, MetricsFormat format) {
+    return format == MetricsFormat::JSON ? metricsToJson(snapshot) : metricsToPrometheus(snapshot);
+}
+
+inline bool writeAll(int fd, const std::string& text) {
+    size_t done = 0;
+    while (done < text.size()) {
+        ssize_t written = ::write(fd, text.data() + done, text.size() - done);
+        if (written <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Escribe la instantánea en el destino:
+//   unix:RUTA   se conecta al socket local RUTA y envía el texto
+//   tcp:PUERTO  se conecta a 127.0.0.1:PUERTO y envía el texto
+//   otra cosa   es un archivo; se escribe aparte y se renombra, así quien lo
+//               lee nunca ve un archivo a medias
+inline bool exportMetrics(const std::string& target, MetricsFormat format) {
+    std::string text = formatMetrics(metricsSnapshot(), format);
+
+    if (target.compare(0, 5, "unix:") == 0 || target.compare(0, 4, "tcp:") == 0) {
+        bool local = target[0] == 'u';
+        int fd = socket(local ? AF_UNIX : AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+        int connected;
+        if (local) {
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            std::string path = target.substr(5);
+            if (path.size() >= sizeof(address.sun_path)) {
+                ::close(fd);
+                return false;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            connected = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        } else {
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(static_cast<uint16_t>(std::atoi(target.c_str() + 4)));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            connected = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        }
+        bool ok = connected == 0 && writeAll(fd, text);
+        ::close(fd);
+        return ok;
+    }
+
+    std::string temporary = target + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+    ok = fclose(file) == 0 && ok;
+    return ok && rename(temporary.c_str(), target.c_str()) == 0;
+}
+
+#endif // BOOPMETRICS_H
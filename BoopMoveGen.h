@@ -0,0 +1,114 @@
+#ifndef BOOPMOVEGEN_H
+#define BOOPMOVEGEN_H
+
+#include "BoopGame.h"
+
+// Generador de jugadas legales. Llena una lista de capacidad fija en la pila,
+// sin crecer vectores: una jugada por cada casilla vacía y tipo de pieza que
+// el jugador que mueve tenga en reserva.
+
+// Alcanza para el tablero más grande (8x8)
+const int MAX_MOVES = MAX_SQUARES * NUM_PIECE_TYPES;
+
+// Lista de jugadas de capacidad fija
+struct MoveList {
+    Move moves[MAX_MOVES];
+    int count = 0;
+
+    void push(const Move& move) { moves[count++] = move; }
+    void clear() { count = 0; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    Move& operator[](int i) { return moves[i]; }
+    const Move& operator[](int i) const { return moves[i]; }
+    Move* begin() { return moves; }
+    Move* end() { return moves + count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+};
+
+// Núcleo común: casillas vacías y si quedan gatitos o gatos en la reserva
+inline void generateMoves(Bitboard empty, bool canPlaceGatito, bool canPlaceGato, MoveList& list) {
+    list.clear();
+    while (empty) {
+        int sq = popLsb(empty);
+        if (canPlaceGato) {
+            list.push(Move(sq, PieceType::GATO));
+        }
+        if (canPlaceGatito) {
+            list.push(Move(sq, PieceType::GATITO));
+        }
+    }
+}
+
+template <int N, int Supply>
+inline void generateMoves(const BasicPosition<N, Supply>& pos, MoveList& list) {
+    if (pos.gameOver) {
+        list.clear();
+        return;
+    }
+    generateMoves(pos.board.empty(), pos.canPlace(PieceType::GATITO), pos.canPlace(PieceType::GATO), list);
+}
+
+template <int N, int Supply>
+inline void generateMoves(const BasicBoop<N, Supply>& game, MoveList& list) {
+    if (game.gameOver) {
+        list.clear();
+        return;
+    }
+    generateMoves(game.board.bits.empty(), game.currentPlayer->canPlaceGatito(),
+                  game.currentPlayer->canPlaceGato(), list);
+}
+
+// Retorna true si la jugada deja una línea de tres de su tipo tras el boop.
+// Los gatos no pueden ser empujados, así que para ellos basta la máscara
+template <int N>
+inline bool completesLine(const BasicBitBoard<N>& board, int side, const Move& move) {
+    int type = typeIndex(move.type);
+    if (!hasLineOfThree<N>(board.pieces[side][type] | squareBit(move.square))) {
+        return false;
+    }
+    if (move.type == PieceType::GATO) {
+        return true;
+    }
+    BasicBitBoard<N> after = board;
+    after.set(side, type, move.square);
+    BoopResult boop;
+    boopAround(after, move.square, boop);
+    return hasLineOfThree<N>(after.pieces[side][type]);
+}
+
+// Variante ordenada: primero las jugadas que ganan (línea de gatos), luego
+// las que gradúan gatitos y después el resto en el orden habitual
+template <int N, int Supply>
+inline void generateOrderedMoves(const BasicPosition<N, Supply>& pos, MoveList& list) {
+    generateMoves(pos, list);
+
+    int side = pos.sideToMove;
+    ThreatMap threats;
+    findThreats(pos.board, threats);
+    Bitboard winning = threats.squares[side][1];
+    Bitboard graduating = threats.squares[side][0];
+    if (!winning && !graduating) {
+        return;
+    }
+
+    int front = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        PieceType wanted = pass == 0 ? PieceType::GATO : PieceType::GATITO;
+        Bitboard squares = pass == 0 ? winning : graduating;
+        for (int i = front; i < list.count; i++) {
+            const Move move = list[i];
+            if (move.type == wanted && (squares & squareBit(move.square)) &&
+                completesLine(pos.board, side, move)) {
+                // Se desplaza el bloque para conservar el orden del resto
+                for (int j = i; j > front; j--) {
+                    list[j] = list[j - 1];
+                }
+                list[front++] = move;
+            }
+        }
+    }
+}
+
+#endif // BOOPMOVEGEN_H
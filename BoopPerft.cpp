@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BoopGame.h"
+#include "BoopPerft.h"
+
+// Herramienta perft: cuenta las posiciones hoja desde la posición inicial
+// (o la que dejan las jugadas de --jugadas) hasta la profundidad pedida.
+//
+// Uso: BoopPerft [--profundidad N] [--hilos N] [--hash MB] [--dividir]
+//                [--tamano 4|5|6|8] [--jugadas "f,c,t f,c,t ..."]
+// Sin --dividir imprime el conteo de cada profundidad de 1 a N; con
+// --dividir imprime el conteo de cada jugada de la raíz a profundidad N.
+// --hash 0 desactiva el caché de subárboles. --tamano elige la variante del
+// tablero, con los gatitos de VARIANT_GATITOS.
+
+struct PerftOptions {
+    int depth = 4;
+    int threads = 1;
+    size_t hashMb = 64;
+    bool divide = false;
+    string moves;
+};
+
+// Aplica una lista de jugadas "fila,columna,tipo" separadas por espacios
+template <int N, int Supply>
+bool playMoves(BasicBoop<N, Supply>& game, const string& text) {
+    NullEventSink events;
+    stringstream ss(text);
+    string token;
+    while (ss >> token) {
+        int row = 0;
+        int col = 0;
+        char type = 0;
+        if (sscanf(token.c_str(), "%d,%d,%c", &row, &col, &type) != 3 || (type != 'g' && type != 'G')) {
+            cerr << "Jugada inválida: " << token << endl;
+            return false;
+        }
+        PieceType pieceType = type == 'g' ? PieceType::GATITO : PieceType::GATO;
+        if (!game.placePiece(row, col, pieceType, events)) {
+            cerr << "Jugada ilegal: " << token << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int N>
+int runPerft(const PerftOptions& options) {
+    using Game = BasicBoop<N, VARIANT_GATITOS<N>>;
+    using Geometry = BoardGeometry<N>;
+
+    Game game;
+    if (!playMoves(game, options.moves)) {
+        return 1;
+    }
+    unique_ptr<typename Game::PositionType> root(new typename Game::PositionType(game.position()));
+    unique_ptr<PerftCache> cache(options.hashMb > 0 ? new PerftCache(options.hashMb) : nullptr);
+    vector<PerftDivide> counts;
+
+    int first = options.divide ? options.depth : 1;
+    for (int d = first; d <= options.depth; d++) {
+        if (cache) {
+            cache->clear();
+        }
+        auto start = chrono::steady_clock::now();
+        uint64_t nodes = perftDivide(*root, d, options.threads, cache.get(), counts);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        if (options.divide) {
+            for (const PerftDivide& entry : counts) {
+                cout << Geometry::rowOf(entry.move.square) << "," << Geometry::colOf(entry.move.square) << ","
+                     << (entry.move.type == PieceType::GATITO ? "g" : "G") << ": " << entry.nodes << endl;
+            }
+        }
+        cout << "profundidad " << d << ": " << nodes << " nodos en " << static_cast<int64_t>(seconds * 1000)
+             << " ms (" << static_cast<int64_t>(nodes / (seconds > 0 ? seconds : 1e-9)) << " nodos/s)" << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    PerftOptions options;
+    options.threads = static_cast<int>(thread::hardware_concurrency());
+    int size = BOARD_SIZE;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--profundidad") == 0 && hasValue) {
+            options.depth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--hilos") == 0 && hasValue) {
+            options.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--hash") == 0 && hasValue) {
+            options.hashMb = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--dividir") == 0) {
+            options.divide = true;
+        } else if (strcmp(argv[i], "--jugadas") == 0 && hasValue) {
+            options.moves = argv[++i];
+        } else if (strcmp(argv[i], "--tamano") == 0 && hasValue) {
+            size = atoi(argv[++i]);
+        } else {
+            cerr << "Opción desconocida: " << argv[i] << endl;
+            return 1;
+        }
+    }
+    if (options.threads < 1) {
+        options.threads = 1;
+    }
+    if (options.depth < 0 || options.depth >= MAX_PLY) {
+        cerr << "Profundidad fuera de rango" << endl;
+        return 1;
+    }
+
+    switch (size) {
+        case 4:
+            return runPerft<4>(options);
+        case 5:
+            return runPerft<5>(options);
+        case 6:
+            return runPerft<6>(options);
+        case 8:
+            return runPerft<8>(options);
+        default:
+            cerr << "Tamaño no soportado: " << size << " (4, 5, 6 u 8)" << endl;
+            return 1;
+    }
+}
@@ -0,0 +1,165 @@
+#ifndef BOOPPERFT_H
+#define BOOPPERFT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "BoopMoveGen.h"
+
+// Perft: cuenta las posiciones hoja alcanzables a una profundidad dada.
+// Sirve para validar la generación de jugadas y el boop contra números
+// conocidos y para medir la velocidad bruta de las reglas.
+// En el último nivel solo se cuentan las jugadas (conteo en bloque) y los
+// subárboles ya contados se pueden guardar en un caché por clave Zobrist.
+
+// Entrada del caché: la clave (mezclada con la profundidad) XOR el conteo y
+// el conteo, igual que en la tabla de transposición, para compartirla entre
+// hilos sin candados
+struct PerftSlot {
+    std::atomic<uint64_t> keyXorCount{0};
+    std::atomic<uint64_t> count{0};
+};
+
+// Clase PerftCache
+class PerftCache {
+public:
+    explicit PerftCache(size_t megabytes = 64) { resize(megabytes); }
+
+    void resize(size_t megabytes);
+    void clear();
+    bool probe(uint64_t key, int depth, uint64_t& nodes) const;
+    void store(uint64_t key, int depth, uint64_t nodes);
+
+private:
+    std::unique_ptr<PerftSlot[]> slots;
+    size_t mask = 0;
+
+    static uint64_t cacheKey(uint64_t key, int depth) {
+        return key ^ (static_cast<uint64_t>(depth) * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
+inline void PerftCache::resize(size_t megabytes) {
+    size_t count = 1;
+    while (count * 2 * sizeof(PerftSlot) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+    slots.reset(new PerftSlot[count]);
+    mask = count - 1;
+}
+
+inline void PerftCache::clear() {
+    for (size_t i = 0; i <= mask; i++) {
+        slots[i].keyXorCount.store(0, std::memory_order_relaxed);
+        slots[i].count.store(0, std::memory_order_relaxed);
+    }
+}
+
+inline bool PerftCache::probe(uint64_t key, int depth, uint64_t& nodes) const {
+    uint64_t mixed = cacheKey(key, depth);
+    const PerftSlot& slot = slots[mixed & mask];
+    uint64_t stored = slot.count.load(std::memory_order_relaxed);
+    // Un conteo de cero nunca se guarda, así que marca una entrada vacía
+    if (stored == 0 || (slot.keyXorCount.load(std::memory_order_relaxed) ^ stored) != mixed) {
+        return false;
+    }
+    nodes = stored;
+    return true;
+}
+
+inline void PerftCache::store(uint64_t key, int depth, uint64_t nodes) {
+    if (nodes == 0) {
+        return;
+    }
+    uint64_t mixed = cacheKey(key, depth);
+    PerftSlot& slot = slots[mixed & mask];
+    slot.keyXorCount.store(mixed ^ nodes, std::memory_order_relaxed);
+    slot.count.store(nodes, std::memory_order_relaxed);
+}
+
+// Conteo recursivo; cache puede ser nullptr
+template <int N, int Supply>
+inline uint64_t perft(BasicPosition<N, Supply>& pos, int depth, PerftCache* cache) {
+    if (depth == 0) {
+        return 1;
+    }
+
+    MoveList moves;
+    generateMoves(pos, moves);
+    if (depth == 1) {
+        return static_cast<uint64_t>(moves.size());
+    }
+
+    uint64_t nodes = 0;
+    if (cache && cache->probe(pos.key, depth, nodes)) {
+        return nodes;
+    }
+    for (const Move& move : moves) {
+        pos.makeMove(move);
+        nodes += perft(pos, depth - 1, cache);
+        pos.unmakeMove();
+    }
+    if (cache) {
+        cache->store(pos.key, depth, nodes);
+    }
+    return nodes;
+}
+
+// Conteo por jugada de la raíz
+struct PerftDivide {
+    Move move;
+    uint64_t nodes = 0;
+};
+
+// Reparte las jugadas de la raíz entre varios hilos. Devuelve el total y
+// deja en divide el conteo de cada jugada, en el orden del generador
+template <int N, int Supply>
+inline uint64_t perftDivide(const BasicPosition<N, Supply>& root, int depth, int threads, PerftCache* cache,
+                            std::vector<PerftDivide>& divide) {
+    divide.clear();
+    if (depth <= 0) {
+        return 1;
+    }
+
+    MoveList moves;
+    generateMoves(root, moves);
+    for (const Move& move : moves) {
+        divide.push_back({move, 0});
+    }
+
+    std::atomic<int> next{0};
+    auto worker = [&] {
+        // Position es grande por su pila de deshacer: cada hilo usa su copia
+        std::unique_ptr<BasicPosition<N, Supply>> pos(new BasicPosition<N, Supply>(root));
+        pos->clearHistory();
+        for (int i = next++; i < static_cast<int>(divide.size()); i = next++) {
+            pos->makeMove(divide[i].move);
+            divide[i].nodes = perft(*pos, depth - 1, cache);
+            pos->unmakeMove();
+        }
+    };
+
+    if (threads < 1) {
+        threads = 1;
+    }
+    std::vector<std::thread> helpers;
+    for (int t = 1; t < threads; t++) {
+        helpers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    uint64_t total = 0;
+    for (const PerftDivide& entry : divide) {
+        total += entry.nodes;
+    }
+    return total;
+}
+
+#endif // BOOPPERFT_H
@@ -0,0 +1,301 @@
+#ifndef BOOPPOSITION_H
+#define BOOPPOSITION_H
+
+#include <cstdint>
+
+#include "BoopBitboard.h"
+#include "BoopZobrist.h"
+
+// Núcleo de reglas sin asignaciones ni salida por pantalla.
+// Position guarda el estado completo de una partida en máscaras y permite
+// hacer y deshacer jugadas con una pila fija de deshacer.
+// BasicPosition<N, Supply> es la variante de NxN con Supply gatitos por
+// jugador; Position es la del juego estándar.
+
+const int INITIAL_GATITOS = 8;
+const int MAX_PLY = 512;
+
+// Gatitos por jugador de cada variante de tamaño: menos en los tableros
+// pequeños que se analizan de forma exhaustiva y más en el de 8x8
+template <int N>
+constexpr int VARIANT_GATITOS = N == 4 ? 4 : N == 5 ? 6 : N == 8 ? 12 : INITIAL_GATITOS;
+
+// Jugada: casilla y tipo de pieza a colocar. row(), col() y el constructor
+// con fila y columna usan el tablero estándar; en otras variantes se
+// convierte con BoardGeometry<N>
+struct Move {
+    uint8_t square = 0;
+    PieceType type = PieceType::GATITO;
+
+    Move() = default;
+    Move(int sq, PieceType t) : square(static_cast<uint8_t>(sq)), type(t) {}
+    Move(int row, int col, PieceType t) : Move(squareOf(row, col), t) {}
+
+    int row() const { return rowOf(square); }
+    int col() const { return colOf(square); }
+
+    bool operator==(const Move& other) const {
+        return square == other.square && type == other.type;
+    }
+    bool operator!=(const Move& other) const {
+        return !(*this == other);
+    }
+};
+
+// Todo lo necesario para deshacer una jugada exactamente
+template <int Supply>
+struct BasicUndoInfo {
+    // Cada jugador tiene como mucho Supply gatitos en el tablero
+    static constexpr int MAX_GRADUATIONS = NUM_PLAYERS * (Supply / LINE_LENGTH);
+
+    Move move;
+    BoopResult boop;
+    uint64_t key;
+    int graduatedCount;
+    uint8_t graduatedLine[MAX_GRADUATIONS];
+    uint8_t graduatedOwner[MAX_GRADUATIONS];
+    int gatitos_disponibles[NUM_PLAYERS];
+    int gatos_disponibles[NUM_PLAYERS];
+    int sideToMove;
+    bool gameOver;
+    int winner;
+};
+
+using UndoInfo = BasicUndoInfo<INITIAL_GATITOS>;
+
+// Clase Position
+template <int N, int Supply>
+class BasicPosition {
+public:
+    using Geometry = BoardGeometry<N>;
+    using Undo = BasicUndoInfo<Supply>;
+
+    BasicBitBoard<N> board;
+    int gatitos_disponibles[NUM_PLAYERS] = {Supply, Supply};
+    int gatos_disponibles[NUM_PLAYERS] = {0, 0};
+    int sideToMove = 0;
+    bool gameOver = false;
+    int winner = -1;
+    // Clave Zobrist, mantenida de forma incremental por makeMove
+    uint64_t key = 0;
+
+    BasicPosition() { refreshKey(); }
+    void refreshKey();
+    bool canPlace(PieceType type) const;
+    bool isLegal(const Move& move) const;
+    void makeMove(const Move& move);
+    void unmakeMove();
+    bool isRepetition() const;
+    int ply() const { return historySize; }
+    // Olvida las jugadas guardadas; el estado actual no cambia
+    void clearHistory() { historySize = 0; }
+    const Undo& lastUndo() const { return history[historySize - 1]; }
+
+private:
+    Undo history[MAX_PLY];
+    int historySize = 0;
+
+    void promoteGatitos(Undo& undo);
+    void checkVictory();
+};
+
+using Position = BasicPosition<BOARD_SIZE, INITIAL_GATITOS>;
+
+// Clave Zobrist de un estado calculada desde cero: piezas, reservas de ambos
+// jugadores y turno. La comparten Position y el juego interactivo
+template <int N>
+inline uint64_t zobristKey(const BasicBitBoard<N>& board, const int gatitos[NUM_PLAYERS], const int gatos[NUM_PLAYERS],
+                           int sideToMove) {
+    uint64_t key = 0;
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            Bitboard pieces = board.pieces[p][t];
+            while (pieces) {
+                key ^= ZOBRIST.piece[p][t][popLsb(pieces)];
+            }
+        }
+        key ^= supplyKey(p, 0, gatitos[p]) ^ supplyKey(p, 1, gatos[p]);
+    }
+    if (sideToMove == 1) {
+        key ^= ZOBRIST.side;
+    }
+    return key;
+}
+
+// Recalcula la clave desde cero; usar tras modificar los campos a mano
+template <int N, int Supply>
+inline void BasicPosition<N, Supply>::refreshKey() {
+    key = zobristKey(board, gatitos_disponibles, gatos_disponibles, sideToMove);
+}
+
+// Revisa que un estado armado a mano pueda salir de una partida: reservas no
+// negativas, los Supply gatitos de cada jugador en el tablero o en la reserva,
+// gatos de a tres (cada graduación da tres) sin pasar del máximo de reserva que
+// distinguen las claves, y ninguna línea completa, que ya se habría graduado o
+// ganado. Devuelve el motivo del rechazo, o nullptr si el estado es válido
+template <int N, int Supply>
+inline const char* invalidPositionReason(const BasicPosition<N, Supply>& pos) {
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        if (pos.gatitos_disponibles[p] < 0 || pos.gatos_disponibles[p] < 0) {
+            return "reserva negativa";
+        }
+        if (popCount(pos.board.pieces[p][0]) + pos.gatitos_disponibles[p] != Supply) {
+            return "los gatitos en el tablero y en la reserva no suman el total";
+        }
+        int gatos = popCount(pos.board.pieces[p][1]) + pos.gatos_disponibles[p];
+        if (gatos % LINE_LENGTH != 0 || pos.gatos_disponibles[p] >= SUPPLY_KEYS) {
+            return "cantidad de gatos imposible";
+        }
+    }
+    BasicLineHits<N> hits;
+    findAllLines(pos.board, hits);
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            if (hits.count[p][t] > 0) {
+                return "hay una línea de tres completa";
+            }
+        }
+    }
+    return nullptr;
+}
+
+template <int N, int Supply>
+inline bool BasicPosition<N, Supply>::canPlace(PieceType type) const {
+    if (type == PieceType::GATITO) {
+        return gatitos_disponibles[sideToMove] > 0;
+    }
+    return gatos_disponibles[sideToMove] > 0;
+}
+
+template <int N, int Supply>
+inline bool BasicPosition<N, Supply>::isLegal(const Move& move) const {
+    return !gameOver && move.square < Geometry::NUM_SQUARES && board.isEmpty(move.square) && canPlace(move.type);
+}
+
+// Aplica una jugada legal: coloca, hace boop, gradúa y revisa victoria.
+// Debe llamarse con como mucho MAX_PLY jugadas pendientes de deshacer.
+template <int N, int Supply>
+inline void BasicPosition<N, Supply>::makeMove(const Move& move) {
+    Undo& undo = history[historySize++];
+    undo.move = move;
+    undo.gatitos_disponibles[0] = gatitos_disponibles[0];
+    undo.gatitos_disponibles[1] = gatitos_disponibles[1];
+    undo.gatos_disponibles[0] = gatos_disponibles[0];
+    undo.gatos_disponibles[1] = gatos_disponibles[1];
+    undo.sideToMove = sideToMove;
+    undo.gameOver = gameOver;
+    undo.winner = winner;
+    undo.key = key;
+
+    board.set(sideToMove, typeIndex(move.type), move.square);
+    key ^= ZOBRIST.piece[sideToMove][typeIndex(move.type)][move.square];
+    if (move.type == PieceType::GATITO) {
+        gatitos_disponibles[sideToMove]--;
+    } else {
+        gatos_disponibles[sideToMove]--;
+    }
+
+    boopAround(board, move.square, undo.boop);
+    for (int i = 0; i < undo.boop.outCount; i++) {
+        gatitos_disponibles[undo.boop.outOwner[i]]++;
+        key ^= ZOBRIST.piece[undo.boop.outOwner[i]][0][undo.boop.outSquare[i]];
+    }
+    for (int i = 0; i < undo.boop.pushedCount; i++) {
+        int to = undo.boop.pushedTo[i];
+        int owner = (board.pieces[1][0] & squareBit(to)) ? 1 : 0;
+        key ^= ZOBRIST.piece[owner][0][undo.boop.pushedFrom[i]] ^ ZOBRIST.piece[owner][0][to];
+    }
+
+    promoteGatitos(undo);
+    checkVictory();
+
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        key ^= supplyKey(p, 0, undo.gatitos_disponibles[p]) ^ supplyKey(p, 0, gatitos_disponibles[p]);
+        key ^= supplyKey(p, 1, undo.gatos_disponibles[p]) ^ supplyKey(p, 1, gatos_disponibles[p]);
+    }
+
+    if (!gameOver) {
+        sideToMove ^= 1;
+        key ^= ZOBRIST.side;
+    }
+}
+
+template <int N, int Supply>
+inline void BasicPosition<N, Supply>::unmakeMove() {
+    const Undo& undo = history[--historySize];
+
+    for (int i = 0; i < undo.graduatedCount; i++) {
+        board.pieces[undo.graduatedOwner[i]][0] |= LINE_TABLE<N>.mask[undo.graduatedLine[i]];
+    }
+    for (int i = 0; i < undo.boop.outCount; i++) {
+        board.pieces[undo.boop.outOwner[i]][0] |= squareBit(undo.boop.outSquare[i]);
+    }
+    for (int i = 0; i < undo.boop.pushedCount; i++) {
+        Bitboard moved = squareBit(undo.boop.pushedTo[i]);
+        int owner = (board.pieces[1][0] & moved) ? 1 : 0;
+        board.pieces[owner][0] ^= moved | squareBit(undo.boop.pushedFrom[i]);
+    }
+    board.clear(undo.sideToMove, typeIndex(undo.move.type), undo.move.square);
+
+    gatitos_disponibles[0] = undo.gatitos_disponibles[0];
+    gatitos_disponibles[1] = undo.gatitos_disponibles[1];
+    gatos_disponibles[0] = undo.gatos_disponibles[0];
+    gatos_disponibles[1] = undo.gatos_disponibles[1];
+    sideToMove = undo.sideToMove;
+    gameOver = undo.gameOver;
+    winner = undo.winner;
+    key = undo.key;
+}
+
+// Retorna true si la posición actual ya apareció antes en la pila de jugadas
+template <int N, int Supply>
+inline bool BasicPosition<N, Supply>::isRepetition() const {
+    for (int i = historySize - 2; i >= 0; i -= 2) {
+        if (history[i].key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Gradúa cada línea de tres gatitos: vuelven a la reserva y dan 3 gatos
+template <int N, int Supply>
+inline void BasicPosition<N, Supply>::promoteGatitos(Undo& undo) {
+    undo.graduatedCount = 0;
+
+    BasicLineHits<N> hits;
+    findAllLines(board, hits);
+
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int i = 0; i < hits.count[p][0]; i++) {
+            int line = hits.lines[p][0][i];
+            Bitboard mask = LINE_TABLE<N>.mask[line];
+            if ((board.pieces[p][0] & mask) != mask) {
+                continue;
+            }
+
+            board.pieces[p][0] &= ~mask;
+            for (int sq : LINE_TABLE<N>.squares[line]) {
+                key ^= ZOBRIST.piece[p][0][sq];
+            }
+            gatitos_disponibles[p] += LINE_LENGTH;
+            gatos_disponibles[p] += 3;
+            undo.graduatedLine[undo.graduatedCount] = static_cast<uint8_t>(line);
+            undo.graduatedOwner[undo.graduatedCount] = static_cast<uint8_t>(p);
+            undo.graduatedCount++;
+        }
+    }
+}
+
+template <int N, int Supply>
+inline void BasicPosition<N, Supply>::checkVictory() {
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        if (hasLineOfThree<N>(board.pieces[p][1])) {
+            gameOver = true;
+            winner = p;
+            return;
+        }
+    }
+}
+
+#endif // BOOPPOSITION_H
@@ -0,0 +1,433 @@
+#ifndef BOOPPROTOCOL_H
+#define BOOPPROTOCOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "BoopGame.h"
+#include "BoopMetrics.h"
+#include "BoopSearch.h"
+
+// Protocolo de texto para usar el motor desde otro programa, parecido a UCI.
+// Se lee una orden por línea de la entrada y la búsqueda corre en un hilo
+// aparte, así que stop y ponderhit se atienden mientras se piensa.
+//
+// Órdenes:
+//   uci                                   identificación, opciones y uciok
+//   isready                               readyok
+//   setoption name <Hash|Threads|MoveOverhead|ThreatNodes> value N
+//       ThreatNodes > 0 busca antes una victoria forzada por amenazas
+//   setoption name BookFile value ARCHIVO  libro de aperturas (BoopBook.h); <empty> lo quita
+//   ucinewgame                            partida nueva y tabla vacía
+//   position startpos [moves f,c,t ...]
+//   position board <casillas> <turno 1|2> <gatitos1> <gatos1> <gatitos2> <gatos2> [moves ...]
+//       las casillas van por filas con '.', 'o', 'O', 'x' y 'X', como en display()
+//       si la posición no puede salir de una partida o una jugada es ilegal se
+//       rechaza todo y queda la posición anterior
+//   go [ponder] [infinite] [movetime MS] [depth N] [nodes N]
+//      [wtime MS] [btime MS] [winc MS] [binc MS] [movestogo N]
+//       wtime/winc son del jugador 1 y btime/binc del jugador 2
+//   stop                                  termina la búsqueda y responde bestmove
+//   ponderhit                             la jugada esperada se jugó: empieza a contar el tiempo
+//   metrics [json|prometheus] [DESTINO]   métricas de BoopMetrics.h; sin DESTINO se
+//       escriben en la salida, si no en un archivo, unix:RUTA o tcp:PUERTO
+//   quit
+//
+// Durante la búsqueda se imprime una línea info por iteración:
+//   info depth D score cp S|mate M nodes N nps X time T pv f,c,t ...
+// y al final bestmove f,c,t [ponder f,c,t], o bestmove (none). Una jugada del
+// libro no tiene líneas info: se anuncia con info string libro.
+
+// Tiempo por jugada cuando no se sabe cuántas jugadas faltan
+const int DEFAULT_MOVES_TO_GO = 30;
+// Margen por defecto para la comunicación con el programa que nos llama
+const int64_t DEFAULT_MOVE_OVERHEAD_MS = 30;
+
+// Escribe una jugada como "fila,columna,tipo"
+inline string formatMove(const Move& move) {
+    return to_string(move.row()) + "," + to_string(move.col()) + "," + (move.type == PieceType::GATITO ? "g" : "G");
+}
+
+// Lee una jugada "fila,columna,tipo"; no revisa que sea legal
+inline bool parseMove(const string& text, int& row, int& col, PieceType& type) {
+    char symbol = 0;
+    char extra = 0;
+    if (sscanf(text.c_str(), "%d,%d,%c%c", &row, &col, &symbol, &extra) != 3 || (symbol != 'g' && symbol != 'G')) {
+        return false;
+    }
+    type = symbol == 'g' ? PieceType::GATITO : PieceType::GATO;
+    return true;
+}
+
+// Clase EngineProtocol
+class EngineProtocol {
+public:
+    EngineProtocol(istream& in, ostream& out, Searcher& searcher);
+    ~EngineProtocol();
+    // Atiende órdenes hasta quit o el fin de la entrada
+    void run();
+
+private:
+    istream& in;
+    ostream& out;
+    Searcher& searcher;
+    Boop game;
+    OpeningBook book;
+    int64_t moveOverheadMs = DEFAULT_MOVE_OVERHEAD_MS;
+
+    thread worker;
+    // Protege la salida y holdResult
+    mutex outputMutex;
+    condition_variable released;
+    // Con ponder o infinite el bestmove espera a stop o ponderhit
+    bool holdResult = false;
+    bool infinite = false;
+    atomic<bool> stopIssued{false};
+    // true desde go hasta justo antes del bestmove; el hilo puede seguir
+    // sin unir después, hasta la próxima orden que lo espere
+    atomic<bool> searching{false};
+
+    bool handle(const string& line);
+    void handleSetOption(istringstream& args);
+    void handlePosition(istringstream& args);
+    void handleGo(istringstream& args);
+    void handleMetrics(istringstream& args);
+    void stopSearch();
+    void release();
+    void searchWorker();
+    void send(const string& line);
+    void sendInfo(const SearchResult& result);
+};
+
+inline EngineProtocol::EngineProtocol(istream& in, ostream& out, Searcher& searcher)
+    : in(in), out(out), searcher(searcher) {
+    searcher.onIteration = [this](const SearchResult& result) {
+        // Un stop que llegó antes de que la búsqueda arrancara se repite aquí
+        if (stopIssued) {
+            this->searcher.stop();
+        }
+        sendInfo(result);
+    };
+}
+
+inline EngineProtocol::~EngineProtocol() {
+    stopSearch();
+    searcher.onIteration = nullptr;
+    if (searcher.book == &book) {
+        searcher.book = nullptr;
+    }
+}
+
+inline void EngineProtocol::run() {
+    string line;
+    while (getline(in, line)) {
+        if (!handle(line)) {
+            break;
+        }
+    }
+    stopSearch();
+}
+
+inline bool EngineProtocol::handle(const string& line) {
+    istringstream args(line);
+    string command;
+    if (!(args >> command)) {
+        return true;
+    }
+
+    if (command == "uci") {
+        send("id name VenceJohnathan3000");
+        send("id author Boop");
+        send("option name Hash type spin default 16 min 1 max 4096");
+        send("option name Threads type spin default 1 min 1 max 256");
+        send("option name MoveOverhead type spin default " + to_string(DEFAULT_MOVE_OVERHEAD_MS) + " min 0 max 5000");
+        send("option name Ponder type check default false");
+        send("option name ThreatNodes type spin default 0 min 0 max 100000000");
+        send("option name BookFile type string default <empty>");
+        send("uciok");
+    } else if (command == "isready") {
+        send("readyok");
+    } else if (command == "setoption") {
+        handleSetOption(args);
+    } else if (command == "metrics") {
+        handleMetrics(args);
+    } else if (command == "ucinewgame") {
+        stopSearch();
+        game = Boop();
+        searcher.table().clear();
+    } else if (command == "position") {
+        stopSearch();
+        handlePosition(args);
+    } else if (command == "go") {
+        stopSearch();
+        handleGo(args);
+    } else if (command == "stop") {
+        stopSearch();
+    } else if (command == "ponderhit") {
+        searcher.ponderHit();
+        if (!infinite) {
+            release();
+        }
+    } else if (command == "quit") {
+        return false;
+    } else {
+        send("info string orden desconocida: " + command);
+    }
+    return true;
+}
+
+inline void EngineProtocol::handleSetOption(istringstream& args) {
+    string token;
+    string name;
+    string value;
+    args >> token >> name >> token >> value;
+    if (searching) {
+        send("info string no se cambian opciones durante la búsqueda");
+        return;
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+
+    long long number = atoll(value.c_str());
+    if (name == "Hash" && number > 0) {
+        searcher.table().resize(static_cast<size_t>(number));
+    } else if (name == "Threads" && number > 0) {
+        searcher.threads = static_cast<int>(number);
+    } else if (name == "MoveOverhead" && number >= 0) {
+        moveOverheadMs = number;
+    } else if (name == "ThreatNodes" && number >= 0) {
+        searcher.threatNodes = static_cast<uint64_t>(number);
+    } else if (name == "BookFile") {
+        if (value.empty() || value == "<empty>") {
+            book.close();
+            searcher.book = nullptr;
+        } else if (book.open(value)) {
+            searcher.book = &book;
+        } else {
+            searcher.book = nullptr;
+            send("info string no se pudo abrir el libro: " + value);
+        }
+    } else if (name != "Ponder") {
+        send("info string opción desconocida: " + name);
+    }
+}
+
+inline void EngineProtocol::handleMetrics(istringstream& args) {
+    string format;
+    string target;
+    args >> format >> target;
+    MetricsFormat chosen = format == "prometheus" ? MetricsFormat::PROMETHEUS : MetricsFormat::JSON;
+    if (target.empty()) {
+        string text = formatMetrics(metricsSnapshot(), chosen);
+        // send agrega el fin de línea
+        text.pop_back();
+        send(text);
+    } else if (exportMetrics(target, chosen)) {
+        send("info string métricas escritas en " + target);
+    } else {
+        send("info string no se pudieron escribir las métricas en " + target);
+    }
+}
+
+inline void EngineProtocol::handlePosition(istringstream& args) {
+    string token;
+    args >> token;
+
+    // La partida nueva se arma aparte: una posición inválida o una jugada
+    // ilegal se rechazan y queda la anterior
+    Boop next;
+    if (token == "board") {
+        string cells;
+        int side = 0;
+        Position pos;
+        args >> cells >> side >> pos.gatitos_disponibles[0] >> pos.gatos_disponibles[0] >> pos.gatitos_disponibles[1] >>
+            pos.gatos_disponibles[1];
+        if (!args || static_cast<int>(cells.size()) != NUM_SQUARES || (side != 1 && side != 2)) {
+            send("info string posición inválida");
+            return;
+        }
+        for (int sq = 0; sq < NUM_SQUARES; sq++) {
+            if (cells[sq] == '.') {
+                continue;
+            }
+            bool found = false;
+            for (int p = 0; p < NUM_PLAYERS && !found; p++) {
+                for (int t = 0; t < NUM_PIECE_TYPES && !found; t++) {
+                    if (cells[sq] == PIECE_SYMBOL[p][t]) {
+                        pos.board.set(p, t, sq);
+                        found = true;
+                    }
+                }
+            }
+            if (!found) {
+                send("info string casilla inválida en la posición: " + string(1, cells[sq]));
+                return;
+            }
+        }
+        pos.sideToMove = side - 1;
+        if (const char* reason = invalidPositionReason(pos)) {
+            send("info string posición inválida: " + string(reason));
+            return;
+        }
+        pos.refreshKey();
+        next.setPosition(pos);
+        args >> token;
+    } else if (token != "startpos") {
+        send("info string posición inválida");
+        return;
+    } else {
+        args >> token;
+    }
+
+    if (token == "moves") {
+        NullEventSink events;
+        while (args >> token) {
+            int row = 0;
+            int col = 0;
+            PieceType type = PieceType::GATITO;
+            if (!parseMove(token, row, col, type) || !next.placePiece(row, col, type, events)) {
+                send("info string jugada ilegal: " + token);
+                return;
+            }
+        }
+    }
+    game = next;
+}
+
+inline void EngineProtocol::handleGo(istringstream& args) {
+    SearchLimits limits;
+    limits.maxDepth = MAX_SEARCH_DEPTH;
+    bool ponder = false;
+    int64_t moveTime = 0;
+    int64_t clock[NUM_PLAYERS] = {-1, -1};
+    int64_t increment[NUM_PLAYERS] = {0, 0};
+    int movesToGo = 0;
+    infinite = false;
+
+    string token;
+    while (args >> token) {
+        if (token == "ponder") {
+            ponder = true;
+        } else if (token == "infinite") {
+            infinite = true;
+        } else if (token == "movetime") {
+            args >> moveTime;
+        } else if (token == "depth") {
+            args >> limits.maxDepth;
+        } else if (token == "nodes") {
+            args >> limits.maxNodes;
+        } else if (token == "wtime") {
+            args >> clock[0];
+        } else if (token == "btime") {
+            args >> clock[1];
+        } else if (token == "winc") {
+            args >> increment[0];
+        } else if (token == "binc") {
+            args >> increment[1];
+        } else if (token == "movestogo") {
+            args >> movesToGo;
+        }
+    }
+
+    if (game.gameOver) {
+        send("bestmove (none)");
+        return;
+    }
+
+    // Tiempo de la jugada: movetime fija el límite; con reloj se reparte lo que
+    // queda entre las jugadas que faltan y no se empieza una iteración pasado
+    // ese reparto, sin pasar nunca de tres veces lo repartido
+    int side = game.currentPlayer->index;
+    if (!infinite && moveTime > 0) {
+        limits.maxTimeMs = max<int64_t>(1, moveTime - moveOverheadMs);
+    } else if (!infinite && clock[side] >= 0) {
+        int64_t left = max<int64_t>(1, clock[side] - moveOverheadMs);
+        int64_t share = left / (movesToGo > 0 ? movesToGo : DEFAULT_MOVES_TO_GO) + increment[side] * 3 / 4;
+        limits.maxTimeMs = max<int64_t>(1, min(share * 3, left));
+        limits.softTimeMs = max<int64_t>(1, min(share, limits.maxTimeMs));
+    }
+    searcher.limits = limits;
+    searcher.setPondering(ponder);
+    stopIssued = false;
+    {
+        lock_guard<mutex> lock(outputMutex);
+        holdResult = ponder || infinite;
+    }
+    searching = true;
+    worker = thread(&EngineProtocol::searchWorker, this);
+}
+
+// Detiene la búsqueda en curso, si la hay, y espera su bestmove
+inline void EngineProtocol::stopSearch() {
+    if (!worker.joinable()) {
+        return;
+    }
+    stopIssued = true;
+    searcher.setPondering(false);
+    searcher.stop();
+    release();
+    worker.join();
+}
+
+inline void EngineProtocol::release() {
+    {
+        lock_guard<mutex> lock(outputMutex);
+        holdResult = false;
+    }
+    released.notify_all();
+}
+
+inline void EngineProtocol::searchWorker() {
+    SearchResult result = searcher.search(game);
+    {
+        unique_lock<mutex> lock(outputMutex);
+        released.wait(lock, [this] { return !holdResult; });
+    }
+    searching = false;
+
+    if (!result.hasMove) {
+        send("bestmove (none)");
+        return;
+    }
+    if (result.fromBook) {
+        send("info string libro");
+    }
+    string line = "bestmove " + formatMove(result.bestMove);
+    if (result.pv.size() > 1) {
+        line += " ponder " + formatMove(result.pv[1]);
+    }
+    send(line);
+}
+
+inline void EngineProtocol::send(const string& line) {
+    lock_guard<mutex> lock(outputMutex);
+    out << line << endl;
+}
+
+inline void EngineProtocol::sendInfo(const SearchResult& result) {
+    ostringstream line;
+    line << "info depth " << result.depth << " score ";
+    if (isWinScore(result.score)) {
+        // Jugadas propias hasta la victoria, negativas si se pierde
+        int plies = WIN_SCORE - abs(result.score);
+        line << "mate " << (result.score > 0 ? (plies + 1) / 2 : -(plies / 2));
+    } else {
+        line << "cp " << result.score;
+    }
+    line << " nodes " << result.nodes << " nps " << result.nps << " time " << result.timeMs << " pv";
+    for (const Move& move : result.pv) {
+        line << " " << formatMove(move);
+    }
+    send(line.str());
+}
+
+#endif // BOOPPROTOCOL_H
@@ -0,0 +1,329 @@
+#ifndef BOOPRECORD_H
+#define BOOPRECORD_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BoopGame.h"
+
+// Registros binarios de partidas. Un archivo es una cabecera de 16 bytes
+// seguida de partidas una detrás de otra; cada partida es:
+//   GameRecordHeader (32 bytes)
+//   una jugada por byte: casilla * 2 + tipo (0 gatito, 1 gato)
+//   si flags tiene RECORD_HAS_SCORES, un int16 por jugada con la evaluación
+//   del motor desde el punto de vista del que movió (NO_RECORD_SCORE si no hay)
+//   relleno hasta múltiplo de 8 bytes
+// Los campos se guardan en el orden de bytes de la máquina, que es
+// little-endian en todas las que usamos.
+// El escritor agrega partidas al final del archivo y el lector lo proyecta
+// en memoria con mmap: recorrer las partidas no copia ni interpreta nada.
+
+const char RECORD_MAGIC[8] = {'B', 'O', 'O', 'P', 'R', 'E', 'C', '1'};
+const uint32_t RECORD_VERSION = 1;
+// Reglas con las que se jugó: por ahora solo las de BoopGame.h
+const uint8_t RULES_STANDARD = 1;
+const uint8_t RECORD_HAS_SCORES = 1;
+const int16_t NO_RECORD_SCORE = INT16_MIN;
+
+// Resultado guardado en la cabecera de cada partida
+enum class RecordResult : uint8_t {
+    PLAYER1_WINS = 0,
+    PLAYER2_WINS = 1,
+    UNFINISHED = 2
+};
+
+struct RecordFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+struct GameRecordHeader {
+    // Bytes de la partida completa, con cabecera y relleno
+    uint32_t size;
+    uint16_t plies;
+    uint8_t boardSize;
+    uint8_t supply;
+    uint8_t rules;
+    uint8_t flags;
+    RecordResult result;
+    uint8_t reserved;
+    uint64_t seed;
+    // Clave Zobrist de la posición final, para comprobar una reproducción
+    uint64_t finalKey;
+};
+
+static_assert(sizeof(RecordFileHeader) == 16, "cabecera de archivo de 16 bytes");
+static_assert(sizeof(GameRecordHeader) == 32, "cabecera de partida de 32 bytes");
+
+inline uint8_t encodeRecordMove(const Move& move) {
+    return static_cast<uint8_t>(move.square * NUM_PIECE_TYPES + typeIndex(move.type));
+}
+
+inline Move decodeRecordMove(uint8_t code) {
+    return Move(code / NUM_PIECE_TYPES, typeFromIndex(code % NUM_PIECE_TYPES));
+}
+
+// Bytes que ocupan la cabecera, las jugadas y las puntuaciones, sin relleno
+inline size_t recordBytes(const GameRecordHeader& header) {
+    size_t plies = header.plies;
+    return sizeof(GameRecordHeader) + plies +
+           ((header.flags & RECORD_HAS_SCORES) ? plies % 2 + plies * sizeof(int16_t) : 0);
+}
+
+// Partida en construcción: se llenan las jugadas y se entrega al escritor
+struct GameRecord {
+    uint64_t seed = 0;
+    uint8_t boardSize = BOARD_SIZE;
+    uint8_t supply = INITIAL_GATITOS;
+    RecordResult result = RecordResult::UNFINISHED;
+    uint64_t finalKey = 0;
+    vector<uint8_t> moves;
+    vector<int16_t> scores;
+
+    void clear() {
+        result = RecordResult::UNFINISHED;
+        finalKey = 0;
+        moves.clear();
+        scores.clear();
+    }
+
+    void addMove(const Move& move, int16_t score = NO_RECORD_SCORE) {
+        moves.push_back(encodeRecordMove(move));
+        scores.push_back(score);
+    }
+
+    bool hasScores() const {
+        for (int16_t score : scores) {
+            if (score != NO_RECORD_SCORE) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Clase GameRecordWriter
+class GameRecordWriter {
+public:
+    GameRecordWriter() = default;
+    ~GameRecordWriter() { close(); }
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    // Abre el archivo para agregar partidas; si está vacío escribe la cabecera
+    bool open(const string& path);
+    bool write(const GameRecord& record);
+    void flush();
+    // Cierra el archivo; devuelve false si no se pudo vaciar el búfer
+    bool close();
+    bool isOpen() const { return file != nullptr; }
+
+private:
+    FILE* file = nullptr;
+    vector<uint8_t> buffer;
+};
+
+inline bool GameRecordWriter::open(const string& path) {
+    close();
+    file = fopen(path.c_str(), "ab");
+    if (!file) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+        RecordFileHeader header = {};
+        memcpy(header.magic, RECORD_MAGIC, sizeof(RECORD_MAGIC));
+        header.version = RECORD_VERSION;
+        if (fwrite(&header, sizeof(header), 1, file) != 1) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool GameRecordWriter::write(const GameRecord& record) {
+    if (!file || record.moves.size() > UINT16_MAX) {
+        return false;
+    }
+    bool withScores = record.hasScores();
+    size_t plies = record.moves.size();
+
+    GameRecordHeader header = {};
+    header.plies = static_cast<uint16_t>(plies);
+    header.boardSize = record.boardSize;
+    header.supply = record.supply;
+    header.rules = RULES_STANDARD;
+    header.flags = withScores ? RECORD_HAS_SCORES : 0;
+    header.result = record.result;
+    header.seed = record.seed;
+    header.finalKey = record.finalKey;
+    size_t size = (recordBytes(header) + 7) & ~size_t(7);
+    header.size = static_cast<uint32_t>(size);
+
+    // Las puntuaciones empiezan alineadas a 2 bytes después de las jugadas
+    buffer.assign(size, 0);
+    memcpy(buffer.data(), &header, sizeof(header));
+    memcpy(buffer.data() + sizeof(header), record.moves.data(), plies);
+    if (withScores) {
+        memcpy(buffer.data() + sizeof(header) + plies + plies % 2, record.scores.data(), plies * sizeof(int16_t));
+    }
+    return fwrite(buffer.data(), 1, size, file) == size;
+}
+
+inline void GameRecordWriter::flush() {
+    if (file) {
+        fflush(file);
+    }
+}
+
+inline bool GameRecordWriter::close() {
+    if (!file) {
+        return true;
+    }
+    bool ok = fclose(file) == 0;
+    file = nullptr;
+    return ok;
+}
+
+// Vista de una partida dentro del archivo proyectado; no copia nada
+struct GameRecordView {
+    const GameRecordHeader* header = nullptr;
+
+    int plies() const { return header->plies; }
+    Move move(int ply) const { return decodeRecordMove(moves()[ply]); }
+    const uint8_t* moves() const { return reinterpret_cast<const uint8_t*>(header + 1); }
+    bool hasScores() const { return header->flags & RECORD_HAS_SCORES; }
+    // Evaluación guardada para la jugada, o NO_RECORD_SCORE
+    int16_t score(int ply) const {
+        if (!hasScores()) {
+            return NO_RECORD_SCORE;
+        }
+        int16_t value;
+        memcpy(&value, moves() + plies() + plies() % 2 + ply * sizeof(int16_t), sizeof(value));
+        return value;
+    }
+};
+
+// Clase GameRecordFile: lector de solo lectura sobre mmap
+class GameRecordFile {
+public:
+    class iterator {
+    public:
+        iterator(const uint8_t* at, const uint8_t* end) : at(at), end(end) { check(); }
+        GameRecordView operator*() const { return {reinterpret_cast<const GameRecordHeader*>(at)}; }
+        iterator& operator++() {
+            at += reinterpret_cast<const GameRecordHeader*>(at)->size;
+            check();
+            return *this;
+        }
+        bool operator!=(const iterator& other) const { return at != other.at; }
+
+    private:
+        const uint8_t* at;
+        const uint8_t* end;
+
+        // Una partida cortada al final del archivo (por ejemplo, un escritor
+        // que se interrumpió) termina el recorrido
+        void check() {
+            if (at == end) {
+                return;
+            }
+            const GameRecordHeader* header = reinterpret_cast<const GameRecordHeader*>(at);
+            if (static_cast<size_t>(end - at) < sizeof(GameRecordHeader) || header->size > static_cast<size_t>(end - at) ||
+                header->size < recordBytes(*header)) {
+                at = end;
+            }
+        }
+    };
+
+    GameRecordFile() = default;
+    ~GameRecordFile() { close(); }
+    GameRecordFile(const GameRecordFile&) = delete;
+    GameRecordFile& operator=(const GameRecordFile&) = delete;
+
+    bool open(const string& path);
+    void close();
+
+    iterator begin() const { return iterator(data ? data + sizeof(RecordFileHeader) : nullptr, endOfData()); }
+    iterator end() const { return iterator(endOfData(), endOfData()); }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+
+    const uint8_t* endOfData() const { return data ? data + length : nullptr; }
+};
+
+inline bool GameRecordFile::open(const string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(RecordFileHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+
+    const RecordFileHeader* header = static_cast<const RecordFileHeader*>(mapped);
+    if (memcmp(header->magic, RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0 || header->version != RECORD_VERSION) {
+        munmap(mapped, info.st_size);
+        return false;
+    }
+    data = static_cast<const uint8_t*>(mapped);
+    length = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+inline void GameRecordFile::close() {
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), length);
+        data = nullptr;
+        length = 0;
+    }
+}
+
+// Reproduce las primeras plies jugadas de la partida (todas con -1) sobre un
+// juego nuevo. Falla si la partida es de otro tablero o si una jugada es ilegal
+template <int N, int Supply, class Sink>
+inline bool replayRecord(const GameRecordView& record, BasicBoop<N, Supply>& game, Sink& events, int plies = -1) {
+    if (record.header->boardSize != N || record.header->supply != Supply || record.header->rules != RULES_STANDARD) {
+        return false;
+    }
+    game = BasicBoop<N, Supply>();
+    int count = plies < 0 || plies > record.plies() ? record.plies() : plies;
+    for (int i = 0; i < count; i++) {
+        Move move = record.move(i);
+        if (move.square >= BoardGeometry<N>::NUM_SQUARES ||
+            !game.placePiece(BoardGeometry<N>::rowOf(move.square), BoardGeometry<N>::colOf(move.square), move.type,
+                             events)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int N, int Supply>
+inline bool replayRecord(const GameRecordView& record, BasicBoop<N, Supply>& game, int plies = -1) {
+    NullEventSink events;
+    return replayRecord(record, game, events, plies);
+}
+
+#endif // BOOPRECORD_H
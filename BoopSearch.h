@@ -0,0 +1,522 @@
+#ifndef BOOPSEARCH_H
+#define BOOPSEARCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "BoopGame.h"
+#include "BoopBook.h"
+#include "BoopEval.h"
+#include "BoopMoveGen.h"
+#include "BoopSymmetry.h"
+#include "BoopTT.h"
+#include "BoopThreats.h"
+
+// Motor de búsqueda para un jugador de computadora: negamax con poda
+// alfa-beta, profundización iterativa, ventanas de aspiración, tabla de
+// transposición y seguimiento de la variante principal.
+// Con más de un hilo usa Lazy SMP: los hilos ayudantes buscan la misma
+// posición a profundidades escalonadas y comparten la tabla de transposición;
+// el resultado es siempre el del hilo principal.
+
+const int MAX_SEARCH_DEPTH = 64;
+const int INFINITE_SCORE = WIN_SCORE + 1;
+const int ASPIRATION_WINDOW = 50;
+
+// Límites de una búsqueda; 0 significa sin límite. Pasado softTimeMs no se
+// empieza otra iteración; maxTimeMs corta la iteración en curso
+struct SearchLimits {
+    int maxDepth = MAX_SEARCH_DEPTH;
+    uint64_t maxNodes = 0;
+    int64_t maxTimeMs = 0;
+    int64_t softTimeMs = 0;
+};
+
+struct SearchResult {
+    Move bestMove;
+    bool hasMove = false;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t timeMs = 0;
+    uint64_t nps = 0;
+    vector<Move> pv;
+    // La jugada salió del libro de aperturas y no se buscó
+    bool fromBook = false;
+};
+
+// Estado propio de cada hilo de búsqueda
+struct SearchThread {
+    int id = 0;
+    Position pos;
+    bool aborted = false;
+    uint64_t nodes = 0;
+    Move pvTable[MAX_SEARCH_DEPTH + 1][MAX_SEARCH_DEPTH + 1];
+    int pvLength[MAX_SEARCH_DEPTH + 1];
+    Move killers[MAX_SEARCH_DEPTH + 1][2];
+    int history[NUM_PLAYERS][NUM_PIECE_TYPES][NUM_SQUARES];
+
+    void reset();
+};
+
+// Clase Searcher
+class Searcher {
+public:
+    SearchLimits limits;
+    // Número de hilos; con 1 la búsqueda es determinista y no crea hilos
+    int threads = 1;
+    // Guarda las posiciones en la tabla por su clave canónica, así las 8
+    // orientaciones de una posición comparten entrada: la jugada sirve para
+    // todas y la puntuación solo para la orientación que la guardó. Apagado
+    // por defecto: las orientaciones se pisan la entrada y la búsqueda
+    // termina visitando más nodos que sin simetrías
+    bool useSymmetry = false;
+    // Libro de aperturas que se consulta antes de buscar desde una partida;
+    // no es del buscador y debe seguir abierto mientras se use
+    const OpeningBook* book = nullptr;
+    // Si es mayor que 0, antes de buscar se intenta demostrar una victoria
+    // por amenazas (BoopThreats.h) con como mucho tantos nodos
+    uint64_t threatNodes = 0;
+    // Se llama al terminar cada iteración con el resultado parcial
+    function<void(const SearchResult&)> onIteration;
+
+    explicit Searcher(size_t ttMegabytes = 16);
+    SearchResult search(const Boop& game);
+    SearchResult search(Position& pos);
+    void stop() { stopRequested = true; }
+    // Mientras pondering es true no cuentan los límites de tiempo ni de nodos;
+    // ponderHit lo apaga y el tiempo empieza a contar desde ese momento
+    void setPondering(bool value) { pondering = value; }
+    void ponderHit();
+    TranspositionTable& table() { return tt; }
+
+private:
+    TranspositionTable tt;
+    ThreatSearch threats;
+    // Elige entre las jugadas del libro; semilla fija para repetir partidas
+    mt19937_64 bookRng{0x426F6F70};
+    atomic<bool> stopRequested{false};
+    atomic<bool> pondering{false};
+    atomic<uint64_t> sharedNodes{0};
+    chrono::steady_clock::time_point startTime;
+    // Milisegundos desde startTime en los que empezó a contar el tiempo
+    atomic<int64_t> clockStartMs{0};
+    // Posiciones de la partida anteriores a la raíz, ordenadas
+    vector<uint64_t> gameKeys;
+    vector<unique_ptr<SearchThread>> workers;
+
+    void iterate(SearchThread& thread, SearchResult& result);
+    int negamax(SearchThread& thread, int depth, int alpha, int beta, int ply);
+    void orderMoves(const SearchThread& thread, MoveList& moves, const Move* ttMove, int ply) const;
+    void countNode(SearchThread& thread);
+    bool shouldStop() const;
+    bool pastSoftLimit() const;
+    bool isRepetition(const Position& pos) const;
+    int64_t elapsedMs() const;
+    void recordMetrics(const SearchResult& result) const;
+};
+
+// Las puntuaciones de victoria se guardan relativas al nodo, no a la raíz
+inline int scoreToTT(int score, int ply) {
+    if (score > WIN_SCORE - MAX_WIN_DISTANCE) return score + ply;
+    if (score < -WIN_SCORE + MAX_WIN_DISTANCE) return score - ply;
+    return score;
+}
+
+inline int scoreFromTT(int score, int ply) {
+    if (score > WIN_SCORE - MAX_WIN_DISTANCE) return score - ply;
+    if (score < -WIN_SCORE + MAX_WIN_DISTANCE) return score + ply;
+    return score;
+}
+
+inline Searcher::Searcher(size_t ttMegabytes) : tt(ttMegabytes) {
+    // La búsqueda de amenazas respeta el tiempo, los nodos, stop y ponder
+    // de esta búsqueda
+    threats.shouldStop = [this] { return shouldStop(); };
+}
+
+inline SearchResult Searcher::search(const Boop& game) {
+    Position pos = game.position();
+    Move bookMove;
+    MetricTimer bookTimer(MetricHistogram::DECISION_MICROS);
+    if (book && book->choose(pos, static_cast<int>(game.keyHistory.size()) - 1, bookRng, bookMove)) {
+        countMetric(MetricCounter::DECISIONS);
+        countMetric(MetricCounter::BOOK_DECISIONS);
+        SearchResult result;
+        result.bestMove = bookMove;
+        result.hasMove = true;
+        result.fromBook = true;
+        result.pv.push_back(bookMove);
+        return result;
+    }
+    bookTimer.cancel();
+    gameKeys = game.keyHistory;
+    sort(gameKeys.begin(), gameKeys.end());
+    SearchResult result = search(pos);
+    gameKeys.clear();
+    return result;
+}
+
+inline void SearchThread::reset() {
+    aborted = false;
+    nodes = 0;
+    for (auto& perPlayer : history) {
+        for (auto& perType : perPlayer) {
+            for (int& value : perType) {
+                value = 0;
+            }
+        }
+    }
+    for (auto& slots : killers) {
+        slots[0] = slots[1] = Move(OFF_BOARD, PieceType::GATITO);
+    }
+}
+
+inline SearchResult Searcher::search(Position& pos) {
+    SearchResult result;
+    startTime = chrono::steady_clock::now();
+    stopRequested = false;
+    sharedNodes = 0;
+    clockStartMs = 0;
+    tt.newSearch();
+
+    MoveList moves;
+    generateMoves(pos, moves);
+    if (moves.empty()) {
+        return result;
+    }
+    result.bestMove = moves[0];
+    result.hasMove = true;
+
+    // Una victoria demostrada por amenazas no necesita la búsqueda completa.
+    // Si la corta el tiempo o stop, sigue la búsqueda normal, que al menos
+    // devuelve una jugada legal
+    if (threatNodes > 0) {
+        threats.limits.maxNodes = threatNodes;
+        ThreatResult forced = threats.search(pos);
+        if (forced.found) {
+            result.bestMove = forced.pv[0];
+            result.pv = forced.pv;
+            result.depth = static_cast<int>(forced.pv.size());
+            result.score = WIN_SCORE - result.depth;
+            result.nodes = forced.nodes;
+            result.timeMs = elapsedMs();
+            result.nps = result.timeMs > 0 ? result.nodes * 1000 / result.timeMs : result.nodes;
+            if (onIteration) {
+                onIteration(result);
+            }
+            recordMetrics(result);
+            return result;
+        }
+    }
+
+    int threadCount = threads > 1 ? threads : 1;
+    while (static_cast<int>(workers.size()) < threadCount) {
+        workers.push_back(make_unique<SearchThread>());
+        workers.back()->id = static_cast<int>(workers.size()) - 1;
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers[i]->pos = pos;
+        workers[i]->reset();
+    }
+
+    vector<thread> helpers;
+    vector<SearchResult> helperResults(threadCount);
+    for (int i = 1; i < threadCount; i++) {
+        helpers.emplace_back([this, i, &helperResults] { iterate(*workers[i], helperResults[i]); });
+    }
+
+    iterate(*workers[0], result);
+
+    stopRequested = true;
+    for (thread& helper : helpers) {
+        helper.join();
+    }
+
+    result.nodes = 0;
+    for (int i = 0; i < threadCount; i++) {
+        result.nodes += workers[i]->nodes;
+    }
+    result.timeMs = elapsedMs();
+    result.nps = result.timeMs > 0 ? result.nodes * 1000 / result.timeMs : result.nodes;
+    recordMetrics(result);
+    return result;
+}
+
+// Profundización iterativa de un hilo. Los ayudantes empiezan en
+// profundidades alternas para repartir el trabajo y nunca reportan
+inline void Searcher::iterate(SearchThread& thread, SearchResult& result) {
+    bool isMain = thread.id == 0;
+    int maxDepth = limits.maxDepth > 0 && limits.maxDepth < MAX_SEARCH_DEPTH ? limits.maxDepth : MAX_SEARCH_DEPTH;
+    int previous = 0;
+
+    for (int depth = isMain ? 1 : 1 + thread.id % 2; depth <= maxDepth; depth++) {
+        int delta = ASPIRATION_WINDOW;
+        int alpha = -INFINITE_SCORE;
+        int beta = INFINITE_SCORE;
+        if (depth >= 3 && !isWinScore(previous)) {
+            alpha = previous - delta;
+            beta = previous + delta;
+        }
+
+        int score;
+        while (true) {
+            score = negamax(thread, depth, alpha, beta, 0);
+            if (thread.aborted) {
+                break;
+            }
+            if (score <= alpha) {
+                alpha = max(-INFINITE_SCORE, alpha - delta);
+            } else if (score >= beta) {
+                beta = min(INFINITE_SCORE, beta + delta);
+            } else {
+                break;
+            }
+            delta *= 2;
+        }
+        if (thread.aborted) {
+            break;
+        }
+
+        previous = score;
+        result.score = score;
+        result.depth = depth;
+        result.bestMove = thread.pvTable[0][0];
+        result.pv.assign(thread.pvTable[0], thread.pvTable[0] + thread.pvLength[0]);
+        result.nodes = sharedNodes + thread.nodes % 1024;
+        result.timeMs = elapsedMs();
+        result.nps = result.timeMs > 0 ? result.nodes * 1000 / result.timeMs : result.nodes;
+        if (isMain && onIteration) {
+            onIteration(result);
+        }
+
+        // Una victoria forzada ya no cambia con más profundidad
+        if (isWinScore(score) && WIN_SCORE - abs(score) <= depth) {
+            break;
+        }
+        if (shouldStop() || (isMain && pastSoftLimit())) {
+            break;
+        }
+    }
+}
+
+inline int Searcher::negamax(SearchThread& thread, int depth, int alpha, int beta, int ply) {
+    Position& pos = thread.pos;
+    thread.pvLength[ply] = 0;
+
+    if (pos.gameOver) {
+        return terminalScore(pos, ply);
+    }
+    // Repetir una posición no progresa: se cuenta como tablas
+    if (ply > 0 && isRepetition(pos)) {
+        return 0;
+    }
+    if (depth <= 0 || ply >= MAX_SEARCH_DEPTH) {
+        return evaluate(pos);
+    }
+
+    countNode(thread);
+    if (thread.aborted) {
+        return 0;
+    }
+
+    int originalAlpha = alpha;
+    TTEntry entry;
+    const Move* ttMove = nullptr;
+    Move hashMove;
+    // Con simetrías la entrada está en la orientación canónica y su jugada se
+    // devuelve a la de la posición
+    CanonicalKey ttKey;
+    ttKey.key = pos.key;
+    if (useSymmetry) {
+        ttKey = canonicalKey(pos);
+    }
+    countMetric(MetricCounter::TT_PROBES);
+    if (tt.probe(ttKey.key, entry)) {
+        countMetric(MetricCounter::TT_HITS);
+        if (entry.hasMove()) {
+            hashMove = transformMove(entry.move(), inverseSymmetry(ttKey.symmetry));
+            // Con varios hilos una entrada puede venir de una colisión de índice;
+            // se valida la jugada antes de usarla
+            if (pos.isLegal(hashMove)) {
+                ttMove = &hashMove;
+            }
+        }
+        // La puntuación solo vale para la misma orientación: al graduar líneas
+        // que se solapan, dos posiciones simétricas pueden valer distinto. De
+        // otra orientación solo se usa la jugada
+        if (ply > 0 && entry.depth >= depth && entry.symmetry == ttKey.symmetry) {
+            int ttScore = scoreFromTT(entry.score, ply);
+            if (entry.bound == Bound::EXACT ||
+                (entry.bound == Bound::LOWER && ttScore >= beta) ||
+                (entry.bound == Bound::UPPER && ttScore <= alpha)) {
+                return ttScore;
+            }
+        }
+    }
+
+    MoveList moves;
+    generateMoves(pos, moves);
+    if (moves.empty()) {
+        // Sin jugadas posibles la partida queda en tablas
+        return 0;
+    }
+    orderMoves(thread, moves, ttMove, ply);
+
+    int best = -INFINITE_SCORE;
+    Move bestMove = moves[0];
+    for (int i = 0; i < moves.size(); i++) {
+        pos.makeMove(moves[i]);
+        int score;
+        if (i == 0) {
+            score = -negamax(thread, depth - 1, -beta, -alpha, ply + 1);
+        } else {
+            // Búsqueda de variante principal: ventana nula y re-búsqueda si mejora
+            score = -negamax(thread, depth - 1, -alpha - 1, -alpha, ply + 1);
+            if (score > alpha && score < beta && !thread.aborted) {
+                score = -negamax(thread, depth - 1, -beta, -alpha, ply + 1);
+            }
+        }
+        pos.unmakeMove();
+        if (thread.aborted) {
+            return 0;
+        }
+
+        if (score > best) {
+            best = score;
+            bestMove = moves[i];
+            if (score > alpha) {
+                alpha = score;
+                thread.pvTable[ply][0] = moves[i];
+                for (int j = 0; j < thread.pvLength[ply + 1]; j++) {
+                    thread.pvTable[ply][j + 1] = thread.pvTable[ply + 1][j];
+                }
+                thread.pvLength[ply] = thread.pvLength[ply + 1] + 1;
+            }
+        }
+        if (alpha >= beta) {
+            if (moves[i] != thread.killers[ply][0]) {
+                thread.killers[ply][1] = thread.killers[ply][0];
+                thread.killers[ply][0] = moves[i];
+            }
+            thread.history[pos.sideToMove][typeIndex(moves[i].type)][moves[i].square] += depth * depth;
+            break;
+        }
+    }
+
+    Bound bound = best >= beta ? Bound::LOWER : (best > originalAlpha ? Bound::EXACT : Bound::UPPER);
+    Move storedMove = transformMove(bestMove, ttKey.symmetry);
+    tt.store(ttKey.key, &storedMove, scoreToTT(best, ply), depth, bound, ttKey.symmetry);
+    return best;
+}
+
+// Orden: jugada de la tabla, jugadas que completan una línea propia,
+// jugadas asesinas, historial y cercanía al centro
+inline void Searcher::orderMoves(const SearchThread& thread, MoveList& moves, const Move* ttMove, int ply) const {
+    const Position& pos = thread.pos;
+    ThreatMap threats;
+    findThreats(pos.board, threats);
+    const Bitboard* completes = threats.squares[pos.sideToMove];
+    int count = moves.size();
+    int scores[MAX_MOVES];
+    for (int i = 0; i < count; i++) {
+        const Move& move = moves[i];
+        if (ttMove && move == *ttMove) {
+            scores[i] = 1 << 30;
+        } else if (completes[typeIndex(move.type)] & squareBit(move.square)) {
+            scores[i] = move.type == PieceType::GATO ? (1 << 29) + 3 : (1 << 29) + 2;
+        } else if (move == thread.killers[ply][0]) {
+            scores[i] = (1 << 29) + 1;
+        } else if (move == thread.killers[ply][1]) {
+            scores[i] = 1 << 29;
+        } else {
+            scores[i] = thread.history[pos.sideToMove][typeIndex(move.type)][move.square];
+            if (CENTER_SQUARES & squareBit(move.square)) scores[i] += 50;
+            if (EDGE_SQUARES & squareBit(move.square)) scores[i] -= 20;
+        }
+    }
+
+    // Ordenación por inserción: las listas son cortas
+    for (int i = 1; i < count; i++) {
+        Move move = moves[i];
+        int score = scores[i];
+        int j = i - 1;
+        while (j >= 0 && scores[j] < score) {
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+            j--;
+        }
+        moves[j + 1] = move;
+        scores[j + 1] = score;
+    }
+}
+
+// Los nodos se publican en bloques de 1024 para no tocar el contador
+// compartido en cada nodo
+inline void Searcher::countNode(SearchThread& thread) {
+    thread.nodes++;
+    if ((thread.nodes & 1023) == 0) {
+        sharedNodes.fetch_add(1024, memory_order_relaxed);
+        if (shouldStop()) {
+            thread.aborted = true;
+        }
+    } else if (stopRequested.load(memory_order_relaxed) && thread.id != 0) {
+        thread.aborted = true;
+    }
+}
+
+inline void Searcher::ponderHit() {
+    clockStartMs = elapsedMs();
+    pondering = false;
+}
+
+inline bool Searcher::shouldStop() const {
+    if (stopRequested) {
+        return true;
+    }
+    if (pondering.load(memory_order_relaxed)) {
+        return false;
+    }
+    if (limits.maxNodes > 0 && sharedNodes >= limits.maxNodes) {
+        return true;
+    }
+    return limits.maxTimeMs > 0 && elapsedMs() - clockStartMs >= limits.maxTimeMs;
+}
+
+inline bool Searcher::pastSoftLimit() const {
+    return !pondering && limits.softTimeMs > 0 && elapsedMs() - clockStartMs >= limits.softTimeMs;
+}
+
+inline bool Searcher::isRepetition(const Position& pos) const {
+    return pos.isRepetition() || binary_search(gameKeys.begin(), gameKeys.end(), pos.key);
+}
+
+// Una decisión más en las métricas: su tiempo, sus nodos y su velocidad
+inline void Searcher::recordMetrics(const SearchResult& result) const {
+#if BOOP_METRICS
+    auto elapsed = chrono::steady_clock::now() - startTime;
+    uint64_t micros = chrono::duration_cast<chrono::microseconds>(elapsed).count();
+    countMetric(MetricCounter::DECISIONS);
+    countMetric(MetricCounter::SEARCH_NODES, result.nodes);
+    countMetric(MetricCounter::SEARCH_MICROS, micros);
+    recordMetric(MetricHistogram::DECISION_MICROS, micros);
+    if (micros > 0) {
+        recordMetric(MetricHistogram::SEARCH_NPS, result.nodes * 1000000 / micros);
+    }
+#else
+    (void)result;
+#endif
+}
+
+inline int64_t Searcher::elapsedMs() const {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - startTime).count();
+}
+
+#endif // BOOPSEARCH_H
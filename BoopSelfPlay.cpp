@@ -0,0 +1,434 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "BoopGame.h"
+#include "BoopMCTS.h"
+#include "BoopMetrics.h"
+#include "BoopMoveGen.h"
+#include "BoopRecord.h"
+#include "BoopSearch.h"
+#include "BoopSymmetry.h"
+
+// Simulador de partidas sin interfaz: juega muchas partidas entre dos
+// políticas configurables repartidas entre todos los núcleos. Cada partida
+// usa su propia semilla derivada de --semilla y de su número, así que los
+// resultados son los mismos sin importar cuántos hilos se usen.
+//
+// Uso: BoopSelfPlay [--partidas N] [--hilos N] [--semilla S]
+//                   [--j1 POLITICA] [--j2 POLITICA]
+//                   [--max-jugadas N] [--apertura N] [--guardar ARCHIVO]
+//                   [--metricas DESTINO [--formato-metricas json|prometheus]
+//                    [--cada SEGUNDOS]]
+//        BoopSelfPlay --leer ARCHIVO [--reproducir] [--unicas]
+// Políticas: azar, codicioso, busqueda:PROFUNDIDAD, mcts:SIMULACIONES
+// --guardar agrega cada partida al archivo de registros (BoopRecord.h), con
+// la evaluación de cada jugada de búsqueda. --leer calcula las estadísticas
+// de un archivo de registros y con --reproducir además vuelve a jugar cada
+// partida con Boop y comprueba que termina en la misma posición. --unicas
+// cuenta las posiciones distintas del archivo, con y sin simetrías.
+// --metricas escribe las métricas de BoopMetrics.h al terminar, y con --cada
+// también cada tantos segundos mientras se juega. DESTINO es un archivo,
+// unix:RUTA para un socket local o tcp:PUERTO para 127.0.0.1.
+
+// Configuración de una política de juego
+struct PolicyConfig {
+    enum Kind { RANDOM, GREEDY, SEARCH, MCTS_PLAYOUTS } kind = RANDOM;
+    int param = 0;
+    string name = "azar";
+};
+
+// Estadísticas acumuladas de un conjunto de partidas
+struct SelfPlayStats {
+    int64_t games = 0;
+    int64_t wins[NUM_PLAYERS] = {0, 0};
+    int64_t draws = 0;
+    int64_t plies = 0;
+    int64_t graduations[NUM_PLAYERS] = {0, 0};
+
+    void add(const SelfPlayStats& other) {
+        games += other.games;
+        draws += other.draws;
+        plies += other.plies;
+        for (int p = 0; p < NUM_PLAYERS; p++) {
+            wins[p] += other.wins[p];
+            graduations[p] += other.graduations[p];
+        }
+    }
+};
+
+bool parsePolicy(const string& text, PolicyConfig& policy) {
+    policy.name = text;
+    if (text == "azar") {
+        policy.kind = PolicyConfig::RANDOM;
+    } else if (text == "codicioso") {
+        policy.kind = PolicyConfig::GREEDY;
+    } else if (text.rfind("busqueda:", 0) == 0) {
+        policy.kind = PolicyConfig::SEARCH;
+        policy.param = atoi(text.c_str() + 9);
+    } else if (text.rfind("mcts:", 0) == 0) {
+        policy.kind = PolicyConfig::MCTS_PLAYOUTS;
+        policy.param = atoi(text.c_str() + 5);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Codicioso: gana si puede, si no gradúa gatitos, si no juega al azar
+Move greedyMove(const Position& pos, const MoveList& moves, mt19937_64& rng) {
+    MoveList ordered;
+    generateOrderedMoves(pos, ordered);
+    const Move& first = ordered[0];
+    if (completesLine(pos.board, pos.sideToMove, first)) {
+        return first;
+    }
+    return moves[rng() % moves.size()];
+}
+
+// Jugador de una partida: guarda el estado que la política necesita
+class SelfPlayAgent {
+public:
+    explicit SelfPlayAgent(const PolicyConfig& config) : policy(config) {
+        if (policy.kind == PolicyConfig::SEARCH) {
+            searcher.reset(new Searcher(1));
+            searcher->limits.maxDepth = policy.param;
+        } else if (policy.kind == PolicyConfig::MCTS_PLAYOUTS) {
+            mcts.reset(new MCTS(1 << 16));
+            mcts->limits.maxPlayouts = policy.param;
+        }
+    }
+
+    // Prepara al agente para una partida nueva con la semilla dada
+    void newGame(uint64_t seed) {
+        if (searcher) {
+            searcher->table().clear();
+        }
+        if (mcts) {
+            mcts->seed = seed;
+            mcts->reset();
+        }
+    }
+
+    // score recibe la evaluación de la búsqueda; las otras políticas no dan una
+    Move choose(Position& pos, const MoveList& moves, mt19937_64& rng, int16_t& score) {
+        score = NO_RECORD_SCORE;
+        switch (policy.kind) {
+            case PolicyConfig::GREEDY:
+                return greedyMove(pos, moves, rng);
+            case PolicyConfig::SEARCH: {
+                SearchResult result = searcher->search(pos);
+                score = static_cast<int16_t>(max(-WIN_SCORE, min(WIN_SCORE, result.score)));
+                return result.bestMove;
+            }
+            case PolicyConfig::MCTS_PLAYOUTS:
+                return mcts->search(pos).bestMove;
+            default:
+                return moves[rng() % moves.size()];
+        }
+    }
+
+private:
+    PolicyConfig policy;
+    unique_ptr<Searcher> searcher;
+    unique_ptr<MCTS> mcts;
+};
+
+// Juega una partida completa. Las primeras jugadas de apertura son al azar
+// para que las políticas deterministas no repitan siempre la misma partida.
+// Si record no es nullptr se llena con las jugadas de la partida
+void playGame(SelfPlayAgent* agents[NUM_PLAYERS], uint64_t seed, int maxPlies, int openingPlies,
+              Position& pos, SelfPlayStats& stats, GameRecord* record) {
+    mt19937_64 rng(seed);
+    if (record) {
+        record->clear();
+        record->seed = seed;
+    }
+    pos = Position();
+    agents[0]->newGame(seed);
+    agents[1]->newGame(seed);
+
+    MoveList moves;
+    int plies = 0;
+    while (!pos.gameOver && plies < maxPlies) {
+        generateMoves(pos, moves);
+        if (moves.empty()) {
+            break;
+        }
+        int16_t score = NO_RECORD_SCORE;
+        Move move = plies < openingPlies ? moves[rng() % moves.size()]
+                                         : agents[pos.sideToMove]->choose(pos, moves, rng, score);
+        pos.makeMove(move);
+        if (record) {
+            record->addMove(move, score);
+        }
+        plies++;
+
+        const UndoInfo& undo = pos.lastUndo();
+        countPlayedMove(undo, pos.gameOver);
+        for (int i = 0; i < undo.graduatedCount; i++) {
+            stats.graduations[undo.graduatedOwner[i]]++;
+        }
+    }
+
+    stats.games++;
+    stats.plies += plies;
+    if (pos.gameOver) {
+        stats.wins[pos.winner]++;
+    } else {
+        stats.draws++;
+    }
+    if (record) {
+        record->result = pos.gameOver ? static_cast<RecordResult>(pos.winner) : RecordResult::UNFINISHED;
+        record->finalKey = pos.key;
+    }
+}
+
+// Estadísticas de un archivo de registros. Sin replay solo se leen las
+// cabeceras; con replay cada partida se vuelve a jugar con Boop
+int readRecords(const string& path, bool replay, bool unique) {
+    GameRecordFile records;
+    if (!records.open(path)) {
+        cerr << "No se pudo leer el archivo de registros: " << path << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    SelfPlayStats total;
+    int64_t mismatches = 0;
+    Boop game;
+    BinaryEventSink events;
+    unordered_set<uint64_t> seen;
+    unordered_set<uint64_t> seenCanonical;
+    unique_ptr<Position> pos(new Position());
+    for (GameRecordView record : records) {
+        // Las posiciones se cuentan con Position, que solo es del tablero
+        // normal; no hace falta deshacer, así que la pila se vacía cada jugada
+        if (unique && record.header->boardSize == BOARD_SIZE && record.header->supply == INITIAL_GATITOS) {
+            *pos = Position();
+            for (int i = 0; i < record.plies() && pos->isLegal(record.move(i)); i++) {
+                pos->makeMove(record.move(i));
+                pos->clearHistory();
+                seen.insert(pos->key);
+                seenCanonical.insert(canonicalKey(*pos).key);
+            }
+        }
+        total.games++;
+        total.plies += record.plies();
+        if (record.header->result == RecordResult::UNFINISHED) {
+            total.draws++;
+        } else {
+            total.wins[static_cast<int>(record.header->result)]++;
+        }
+        if (!replay) {
+            continue;
+        }
+
+        events.clear();
+        if (!replayRecord(record, game, events) || game.keyHistory.back() != record.header->finalKey) {
+            mismatches++;
+            continue;
+        }
+        for (size_t i = 0; i < events.records.size(); i += 4) {
+            if (events.records[i] == BinaryEventSink::GRADUATED) {
+                total.graduations[events.records[i + 1]]++;
+            }
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double read = total.games > 0 ? static_cast<double>(total.games) : 1.0;
+
+    cout << fixed << setprecision(2);
+    cout << "Partidas: " << total.games << " (" << path << ")" << endl;
+    cout << "Partidas por segundo: " << total.games / (seconds > 0 ? seconds : 1e-9) << endl;
+    cout << "Victorias Jugador 1: " << 100.0 * total.wins[0] / read << "%" << endl;
+    cout << "Victorias Jugador 2: " << 100.0 * total.wins[1] / read << "%" << endl;
+    cout << "Tablas o sin terminar: " << 100.0 * total.draws / read << "%" << endl;
+    cout << "Duración media: " << total.plies / read << " jugadas" << endl;
+    if (replay) {
+        cout << "Graduaciones por partida: Jugador 1 " << total.graduations[0] / read
+             << ", Jugador 2 " << total.graduations[1] / read << endl;
+        cout << "Reproducciones distintas del registro: " << mismatches << endl;
+    }
+    if (unique) {
+        cout << "Posiciones distintas: " << seen.size() << " (" << seenCanonical.size() << " salvo simetrías)"
+             << endl;
+    }
+    return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    int64_t games = 1000;
+    int threads = static_cast<int>(thread::hardware_concurrency());
+    uint64_t seed = 1;
+    int maxPlies = 300;
+    int openingPlies = 2;
+    PolicyConfig policies[NUM_PLAYERS];
+    string savePath;
+    string readPath;
+    bool replay = false;
+    bool unique = false;
+    string metricsTarget;
+    MetricsFormat metricsFormat = MetricsFormat::JSON;
+    int metricsSeconds = 0;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--partidas") == 0 && hasValue) {
+            games = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--hilos") == 0 && hasValue) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--semilla") == 0 && hasValue) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--max-jugadas") == 0 && hasValue) {
+            maxPlies = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--apertura") == 0 && hasValue) {
+            openingPlies = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--guardar") == 0 && hasValue) {
+            savePath = argv[++i];
+        } else if (strcmp(argv[i], "--leer") == 0 && hasValue) {
+            readPath = argv[++i];
+        } else if (strcmp(argv[i], "--reproducir") == 0) {
+            replay = true;
+        } else if (strcmp(argv[i], "--unicas") == 0) {
+            unique = true;
+        } else if (strcmp(argv[i], "--metricas") == 0 && hasValue) {
+            metricsTarget = argv[++i];
+        } else if (strcmp(argv[i], "--formato-metricas") == 0 && hasValue) {
+            string format = argv[++i];
+            if (format == "json") {
+                metricsFormat = MetricsFormat::JSON;
+            } else if (format == "prometheus") {
+                metricsFormat = MetricsFormat::PROMETHEUS;
+            } else {
+                cerr << "Formato de métricas desconocido: " << format << " (json o prometheus)" << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--cada") == 0 && hasValue) {
+            metricsSeconds = atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--j1") == 0 || strcmp(argv[i], "--j2") == 0) && hasValue) {
+            int seat = argv[i][3] - '1';
+            if (!parsePolicy(argv[++i], policies[seat])) {
+                cerr << "Política desconocida: " << argv[i] << endl;
+                return 1;
+            }
+        } else {
+            cerr << "Opción desconocida: " << argv[i] << endl;
+            return 1;
+        }
+    }
+    if (!readPath.empty()) {
+        return readRecords(readPath, replay, unique);
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+    // La pila de deshacer de Position debe alcanzar para la partida y la búsqueda
+    if (maxPlies > MAX_PLY - MAX_SEARCH_DEPTH - 1) {
+        maxPlies = MAX_PLY - MAX_SEARCH_DEPTH - 1;
+    }
+
+    // Los hilos escriben cada partida al terminarla, en el orden en que terminan
+    GameRecordWriter writer;
+    mutex writerMutex;
+    if (!savePath.empty() && !writer.open(savePath)) {
+        cerr << "No se pudo abrir el archivo de registros: " << savePath << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    atomic<int64_t> nextGame{0};
+    // Si falla una escritura los hilos dejan de jugar: el archivo quedaría
+    // sin las partidas siguientes
+    atomic<bool> writeFailed{false};
+    vector<SelfPlayStats> perThread(threads);
+    vector<thread> workers;
+
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            SelfPlayAgent first(policies[0]);
+            SelfPlayAgent second(policies[1]);
+            SelfPlayAgent* agents[NUM_PLAYERS] = {&first, &second};
+            unique_ptr<Position> pos(new Position());
+            GameRecord record;
+            GameRecord* recording = writer.isOpen() ? &record : nullptr;
+
+            for (int64_t game = nextGame++; game < games && !writeFailed; game = nextGame++) {
+                uint64_t state = seed + static_cast<uint64_t>(game) * 0x9E3779B97F4A7C15ULL;
+                playGame(agents, splitmix64(state), maxPlies, openingPlies, *pos, perThread[t], recording);
+                if (recording) {
+                    lock_guard<mutex> lock(writerMutex);
+                    if (!writeFailed && !writer.write(record)) {
+                        writeFailed = true;
+                    }
+                }
+            }
+        });
+    }
+
+    // Exporta las métricas periódicamente hasta que terminen las partidas
+    mutex reporterMutex;
+    condition_variable finished;
+    bool done = false;
+    thread reporter;
+    if (!metricsTarget.empty() && metricsSeconds > 0) {
+        reporter = thread([&] {
+            unique_lock<mutex> lock(reporterMutex);
+            while (!finished.wait_for(lock, chrono::seconds(metricsSeconds), [&] { return done; })) {
+                if (!exportMetrics(metricsTarget, metricsFormat)) {
+                    cerr << "No se pudieron escribir las métricas en " << metricsTarget << endl;
+                }
+            }
+        });
+    }
+
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    if (reporter.joinable()) {
+        {
+            lock_guard<mutex> lock(reporterMutex);
+            done = true;
+        }
+        finished.notify_one();
+        reporter.join();
+    }
+    if (!metricsTarget.empty() && !exportMetrics(metricsTarget, metricsFormat)) {
+        cerr << "No se pudieron escribir las métricas en " << metricsTarget << endl;
+    }
+    if (writeFailed || !writer.close()) {
+        cerr << "No se pudo escribir el archivo de registros: " << savePath << endl;
+        return 1;
+    }
+
+    SelfPlayStats total;
+    for (const SelfPlayStats& stats : perThread) {
+        total.add(stats);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double played = total.games > 0 ? static_cast<double>(total.games) : 1.0;
+
+    cout << fixed << setprecision(2);
+    cout << "Partidas: " << total.games << " (" << threads << " hilos, semilla " << seed << ")" << endl;
+    cout << "Jugador 1: " << policies[0].name << "  |  Jugador 2: " << policies[1].name << endl;
+    cout << "Partidas por segundo: " << total.games / (seconds > 0 ? seconds : 1e-9) << endl;
+    cout << "Victorias Jugador 1: " << 100.0 * total.wins[0] / played << "%" << endl;
+    cout << "Victorias Jugador 2: " << 100.0 * total.wins[1] / played << "%" << endl;
+    cout << "Tablas o sin terminar: " << 100.0 * total.draws / played << "%" << endl;
+    cout << "Duración media: " << total.plies / played << " jugadas" << endl;
+    cout << "Graduaciones por partida: Jugador 1 " << total.graduations[0] / played
+         << ", Jugador 2 " << total.graduations[1] / played << endl;
+    return 0;
+}
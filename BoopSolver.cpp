@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BoopGame.h"
+#include "BoopSolver.h"
+
+// Solucionador de las variantes pequeñas y consultas de juego perfecto.
+//
+// Uso: BoopSolver --resolver ARCHIVO [--tamano 4|5] [--gatitos N]
+//                 [--jugadas "f,c,t f,c,t ..."] [--hilos N] [--memoria MB]
+//      BoopSolver --consultar ARCHIVO [--jugadas "f,c,t f,c,t ..."]
+// --resolver enumera los estados alcanzables desde la posición inicial (o la
+// que dejan las jugadas de --jugadas) y escribe la base con el valor de cada
+// uno. --gatitos va de 3 a VARIANT_GATITOS del tamaño, que es el valor por
+// defecto. --memoria limita las claves que se ordenan en memoria antes de
+// volcarlas a disco. Mientras resuelve usa archivos temporales junto a la
+// base (ARCHIVO.vistos, ARCHIVO.frontera y ARCHIVO.tramoN).
+// --consultar muestra el valor de la raíz de la base (o de la posición tras
+// --jugadas, aplicadas desde esa raíz) y el de cada jugada.
+
+struct SolverToolOptions {
+    string path;
+    bool query = false;
+    int size = 4;
+    int supply = 0;
+    string moves;
+    SolverOptions solver;
+};
+
+// Aplica una lista de jugadas "fila,columna,tipo" separadas por espacios
+template <int N, int Supply>
+bool playMoves(BasicPosition<N, Supply>& pos, const string& text) {
+    stringstream ss(text);
+    string token;
+    while (ss >> token) {
+        int row = 0;
+        int col = 0;
+        char type = 0;
+        if (sscanf(token.c_str(), "%d,%d,%c", &row, &col, &type) != 3 || (type != 'g' && type != 'G') || row < 0 ||
+            row >= N || col < 0 || col >= N) {
+            cerr << "Jugada inválida: " << token << endl;
+            return false;
+        }
+        Move move(BoardGeometry<N>::squareOf(row, col), type == 'g' ? PieceType::GATITO : PieceType::GATO);
+        if (!pos.isLegal(move)) {
+            cerr << "Jugada ilegal: " << token << endl;
+            return false;
+        }
+        pos.makeMove(move);
+        pos.clearHistory();
+    }
+    return true;
+}
+
+string describeValue(const SolverValue& value) {
+    switch (value.result) {
+        case SolverResult::WIN:
+            return "gana en " + to_string(value.plies) + " jugadas";
+        case SolverResult::LOSS:
+            return "pierde en " + to_string(value.plies) + " jugadas";
+        case SolverResult::DRAW:
+            return "tablas";
+        default:
+            return "fuera de la base";
+    }
+}
+
+template <int N, int Supply>
+void printPosition(const BasicPosition<N, Supply>& pos) {
+    for (int row = 0; row < N; row++) {
+        for (int col = 0; col < N; col++) {
+            int sq = BoardGeometry<N>::squareOf(row, col);
+            int owner = pos.board.ownerAt(sq);
+            cout << (owner < 0 ? '.' : PIECE_SYMBOL[owner][pos.board.typeAt(sq)]) << ' ';
+        }
+        cout << endl;
+    }
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        cout << "Jugador " << p + 1 << ": " << pos.gatitos_disponibles[p] << " gatitos y " << pos.gatos_disponibles[p]
+             << " gatos en reserva" << endl;
+    }
+    cout << "Mueve el jugador " << pos.sideToMove + 1 << endl;
+}
+
+template <int N, int Supply>
+int runSolve(const SolverToolOptions& options) {
+    unique_ptr<BasicPosition<N, Supply>> root(new BasicPosition<N, Supply>());
+    if (!playMoves(*root, options.moves)) {
+        return 1;
+    }
+
+    Solver<N, Supply> solver;
+    solver.options = options.solver;
+    auto start = chrono::steady_clock::now();
+    solver.onProgress = [&](const string& line) {
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("[%8.1f s] %s\n", seconds, line.c_str());
+        fflush(stdout);
+    };
+    cout << "Resolviendo " << N << "x" << N << " con " << Supply << " gatitos por jugador" << endl;
+    if (!solver.solve(*root, options.path)) {
+        return 1;
+    }
+
+    SolverDatabase database;
+    if (!database.open(options.path)) {
+        cerr << "No se pudo abrir la base escrita: " << options.path << endl;
+        return 1;
+    }
+    const SolverFileHeader& header = database.header();
+    cout << "Estados: " << header.states << " (" << header.wins << " ganados, " << header.losses << " perdidos, "
+         << header.draws << " tablas) en " << header.passes << " pasadas" << endl;
+    cout << "Raíz: " << describeValue(database.probe(*root)) << endl;
+    return 0;
+}
+
+template <int N, int Supply>
+int runQuery(const SolverToolOptions& options) {
+    SolverDatabase database;
+    if (!database.open(options.path)) {
+        cerr << "No se pudo abrir la base: " << options.path << endl;
+        return 1;
+    }
+    unique_ptr<BasicPosition<N, Supply>> pos(new BasicPosition<N, Supply>());
+    database.root(*pos);
+    if (!playMoves(*pos, options.moves)) {
+        return 1;
+    }
+
+    printPosition(*pos);
+    cout << "Valor: " << describeValue(database.probe(*pos)) << endl;
+    MoveList moves;
+    generateMoves(*pos, moves);
+    vector<pair<Move, SolverValue>> values;
+    for (const Move& move : moves) {
+        values.emplace_back(move, database.probeMove(*pos, move));
+    }
+    Move best;
+    SolverValue bestValue;
+    if (database.bestMove(*pos, best, bestValue)) {
+        cout << "Mejor jugada: " << BoardGeometry<N>::rowOf(best.square) << "," << BoardGeometry<N>::colOf(best.square)
+             << "," << (best.type == PieceType::GATITO ? "g" : "G") << " (" << describeValue(bestValue) << ")" << endl;
+    }
+    for (const auto& entry : values) {
+        const Move& move = entry.first;
+        cout << "  " << BoardGeometry<N>::rowOf(move.square) << "," << BoardGeometry<N>::colOf(move.square) << ","
+             << (move.type == PieceType::GATITO ? "g" : "G") << ": " << describeValue(entry.second) << endl;
+    }
+    return 0;
+}
+
+template <int N, int Supply>
+int run(const SolverToolOptions& options) {
+    return options.query ? runQuery<N, Supply>(options) : runSolve<N, Supply>(options);
+}
+
+int main(int argc, char* argv[]) {
+    SolverToolOptions options;
+    options.solver.threads = static_cast<int>(thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--resolver") == 0 && hasValue) {
+            options.path = argv[++i];
+            options.query = false;
+        } else if (strcmp(argv[i], "--consultar") == 0 && hasValue) {
+            options.path = argv[++i];
+            options.query = true;
+        } else if (strcmp(argv[i], "--tamano") == 0 && hasValue) {
+            options.size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--gatitos") == 0 && hasValue) {
+            options.supply = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--jugadas") == 0 && hasValue) {
+            options.moves = argv[++i];
+        } else if (strcmp(argv[i], "--hilos") == 0 && hasValue) {
+            options.solver.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--memoria") == 0 && hasValue) {
+            options.solver.memoryMb = strtoull(argv[++i], nullptr, 10);
+        } else {
+            cerr << "Opción desconocida: " << argv[i] << endl;
+            return 1;
+        }
+    }
+    if (options.path.empty()) {
+        cerr << "Falta --resolver ARCHIVO o --consultar ARCHIVO" << endl;
+        return 1;
+    }
+    if (options.solver.threads < 1) {
+        options.solver.threads = 1;
+    }
+    if (options.solver.memoryMb < 1) {
+        options.solver.memoryMb = 1;
+    }
+
+    // Al consultar, la variante es la de la base
+    if (options.query) {
+        SolverDatabase database;
+        if (!database.open(options.path)) {
+            cerr << "No se pudo abrir la base: " << options.path << endl;
+            return 1;
+        }
+        options.size = database.header().boardSize;
+        options.supply = database.header().supply;
+    } else if (options.supply == 0) {
+        options.supply = options.size == 5 ? VARIANT_GATITOS<5> : VARIANT_GATITOS<4>;
+    }
+
+    switch (options.size * 10 + options.supply) {
+        case 43:
+            return run<4, 3>(options);
+        case 44:
+            return run<4, 4>(options);
+        case 53:
+            return run<5, 3>(options);
+        case 54:
+            return run<5, 4>(options);
+        case 55:
+            return run<5, 5>(options);
+        case 56:
+            return run<5, 6>(options);
+        default:
+            cerr << "Variante no soportada: " << options.size << "x" << options.size << " con " << options.supply
+                 << " gatitos (4x4 con 3 o 4, 5x5 con 3 a 6)" << endl;
+            return 1;
+    }
+}
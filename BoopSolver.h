@@ -0,0 +1,996 @@
+#ifndef BOOPSOLVER_H
+#define BOOPSOLVER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BoopMoveGen.h"
+
+// Solución exacta de las variantes pequeñas (4x4 y 5x5 con pocas piezas).
+// El solucionador trabaja en tres etapas:
+//  1. Enumeración en anchura de todos los estados alcanzables desde la raíz.
+//     Cada nivel se expande con varios hilos; las claves se ordenan en tramos
+//     que se vuelcan a disco y se mezclan con las ya vistas, así que el número
+//     de estados no está limitado por la memoria.
+//  2. Hash perfecto mínimo sobre las claves (al estilo de BBHash): unos 3 bits
+//     por estado dan el índice de cada uno sin guardar las claves.
+//  3. Análisis retrógrado por pasadas. En la pasada k gana el que mueve si
+//     tiene una jugada a un estado perdido en menos de k jugadas, y pierde si
+//     todas sus jugadas llevan a estados ganados en menos de k; así cada
+//     estado queda con su distancia exacta al final. Lo que sigue sin resolver
+//     cuando una pasada no cambia nada son tablas: nadie puede forzar la
+//     victoria y la partida se repite o se queda sin jugadas.
+//
+// La base es un archivo proyectado con mmap: cabecera, hash perfecto, una
+// huella de 8 bits por estado (para reconocer posiciones que no están) y el
+// valor de cada estado en 16 bits. El análisis escribe sobre el mismo archivo,
+// así que el sistema lo baja a disco si no cabe en memoria.
+//
+// Los gatos nunca salen del tablero: un jugador no puede colocar más gatos que
+// casillas sin gato haya. La clave guarda la reserva de gatos recortada a ese
+// número, lo que hace finito el espacio de estados sin cambiar ningún valor.
+
+const char SOLVER_MAGIC[8] = {'B', 'O', 'O', 'P', 'S', 'O', 'L', '1'};
+const uint32_t SOLVER_VERSION = 1;
+const int SOLVER_MAX_HASH_LEVELS = 32;
+// Bits por clave en cada nivel del hash perfecto: más bits, menos niveles
+const double SOLVER_HASH_GAMMA = 2.0;
+const uint64_t SOLVER_NOT_FOUND = ~uint64_t(0);
+
+// Valor guardado: 0 son tablas; si no, la distancia en jugadas hasta el final
+// con juego perfecto, con SOLVER_LOSS_FLAG si pierde el que mueve
+const uint16_t SOLVER_LOSS_FLAG = 0x8000;
+const int SOLVER_MAX_DISTANCE = 0x7FFF;
+
+enum class SolverResult {
+    WIN,
+    LOSS,
+    DRAW,
+    // La posición no está en la base
+    UNKNOWN
+};
+
+struct SolverValue {
+    SolverResult result = SolverResult::UNKNOWN;
+    int plies = 0;
+};
+
+inline SolverValue decodeSolverValue(uint16_t value) {
+    SolverValue decoded;
+    if (value == 0) {
+        decoded.result = SolverResult::DRAW;
+    } else {
+        decoded.result = (value & SOLVER_LOSS_FLAG) ? SolverResult::LOSS : SolverResult::WIN;
+        decoded.plies = value & SOLVER_MAX_DISTANCE;
+    }
+    return decoded;
+}
+
+// Clave de un estado: el tablero en base 5 (0 vacía, si no 1 + jugador * 2 +
+// tipo, como Piece), luego las reservas de gatos recortadas y el turno. Las
+// reservas de gatitos se deducen de los gatitos en el tablero. En 4x4 cabe en
+// 64 bits; en 5x5 se usan 128
+template <int N>
+struct SolverCodec {
+    static constexpr int NUM_SQUARES = N * N;
+    static constexpr uint64_t RESERVE_VALUES = NUM_SQUARES + 1;
+    static constexpr uint64_t EXTRA_VALUES = RESERVE_VALUES * RESERVE_VALUES * NUM_PLAYERS;
+
+    static_assert(NUM_SQUARES <= 27, "El tablero debe caber en base 5 en 64 bits");
+
+    static constexpr unsigned __int128 boardValues() {
+        unsigned __int128 values = 1;
+        for (int i = 0; i < NUM_SQUARES; i++) {
+            values *= 5;
+        }
+        return values;
+    }
+
+    using Key = typename conditional<(boardValues() * EXTRA_VALUES <= UINT64_MAX), uint64_t, unsigned __int128>::type;
+
+    template <int Supply>
+    static Key encode(const BasicPosition<N, Supply>& pos);
+    template <int Supply>
+    static void decode(Key key, BasicPosition<N, Supply>& pos);
+};
+
+template <int N>
+template <int Supply>
+inline typename SolverCodec<N>::Key SolverCodec<N>::encode(const BasicPosition<N, Supply>& pos) {
+    const Bitboard(&pieces)[NUM_PLAYERS][NUM_PIECE_TYPES] = pos.board.pieces;
+    uint64_t board = 0;
+    for (int sq = NUM_SQUARES - 1; sq >= 0; sq--) {
+        board = board * 5 + ((pieces[0][0] >> sq) & 1) + ((pieces[0][1] >> sq) & 1) * 2 +
+                ((pieces[1][0] >> sq) & 1) * 3 + ((pieces[1][1] >> sq) & 1) * 4;
+    }
+    int cap = NUM_SQUARES - popCount(pos.board.ofType(1));
+    uint64_t extra = (min(pos.gatos_disponibles[0], cap) * RESERVE_VALUES + min(pos.gatos_disponibles[1], cap)) *
+                         NUM_PLAYERS +
+                     pos.sideToMove;
+    return static_cast<Key>(board) * EXTRA_VALUES + extra;
+}
+
+template <int N>
+template <int Supply>
+inline void SolverCodec<N>::decode(Key key, BasicPosition<N, Supply>& pos) {
+    uint64_t board = static_cast<uint64_t>(key / EXTRA_VALUES);
+    uint64_t extra = static_cast<uint64_t>(key - static_cast<Key>(board) * EXTRA_VALUES);
+
+    pos.board = BasicBitBoard<N>();
+    for (int sq = 0; sq < NUM_SQUARES; sq++) {
+        int code = static_cast<int>(board % 5);
+        board /= 5;
+        if (code != 0) {
+            pos.board.set((code - 1) / NUM_PIECE_TYPES, (code - 1) % NUM_PIECE_TYPES, sq);
+        }
+    }
+    pos.sideToMove = static_cast<int>(extra % NUM_PLAYERS);
+    extra /= NUM_PLAYERS;
+    pos.gatos_disponibles[1] = static_cast<int>(extra % RESERVE_VALUES);
+    pos.gatos_disponibles[0] = static_cast<int>(extra / RESERVE_VALUES);
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        pos.gatitos_disponibles[p] = Supply - popCount(pos.board.pieces[p][0]);
+    }
+    pos.gameOver = false;
+    pos.winner = -1;
+    pos.clearHistory();
+    pos.refreshKey();
+}
+
+// Mezcla una clave con una semilla; cada nivel del hash usa la suya
+inline uint64_t mixSolverKey(uint64_t key, uint64_t seed) {
+    uint64_t state = key ^ (seed * 0xD6E8FEB86659FD93ULL);
+    return splitmix64(state);
+}
+
+inline uint64_t mixSolverKey(unsigned __int128 key, uint64_t seed) {
+    return mixSolverKey(static_cast<uint64_t>(key) ^ mixSolverKey(static_cast<uint64_t>(key >> 64), seed), seed);
+}
+
+// Huella de la clave, independiente de los niveles del hash
+template <class Key>
+inline uint8_t solverFingerprint(Key key) {
+    return static_cast<uint8_t>(mixSolverKey(key, SOLVER_MAX_HASH_LEVELS + 1) >> 56);
+}
+
+// Casilla de la clave dentro de un nivel de bits casillas
+template <class Key>
+inline uint64_t solverHashSlot(Key key, int level, uint64_t bits) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(mixSolverKey(key, level + 1)) * bits) >> 64);
+}
+
+// Cabecera del archivo de la base. Después vienen, alineados a 8 bytes, las
+// palabras del hash perfecto, la tabla de rangos (un contador cada 8
+// palabras), las huellas y los valores
+struct SolverFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint8_t boardSize;
+    uint8_t supply;
+    // 1 cuando el análisis terminó
+    uint8_t complete;
+    uint8_t reserved;
+    uint64_t states;
+    // Clave de la raíz, parte baja y alta
+    uint64_t rootKey[2];
+    uint64_t wins;
+    uint64_t losses;
+    uint64_t draws;
+    uint32_t passes;
+    uint32_t hashLevels;
+    uint64_t hashWords;
+    uint64_t levelBits[SOLVER_MAX_HASH_LEVELS];
+    uint64_t levelWord[SOLVER_MAX_HASH_LEVELS];
+};
+
+static_assert(sizeof(SolverFileHeader) % 8 == 0, "cabecera alineada a 8 bytes");
+
+// Desplazamientos de cada sección dentro del archivo
+struct SolverLayout {
+    size_t words;
+    size_t ranks;
+    size_t fingerprints;
+    size_t values;
+    size_t total;
+};
+
+inline SolverLayout solverLayout(const SolverFileHeader& header) {
+    SolverLayout layout;
+    layout.words = sizeof(SolverFileHeader);
+    layout.ranks = layout.words + header.hashWords * sizeof(uint64_t);
+    layout.fingerprints = layout.ranks + (header.hashWords + 7) / 8 * sizeof(uint64_t);
+    layout.values = layout.fingerprints + (header.states + 7) / 8 * 8;
+    layout.total = layout.values + header.states * sizeof(uint16_t);
+    return layout;
+}
+
+// Clase PerfectHash: consulta del hash perfecto sobre palabras ya construidas,
+// en memoria o dentro del archivo proyectado
+class PerfectHash {
+public:
+    void attach(const SolverFileHeader& header, const uint64_t* words, const uint64_t* ranks);
+    // Índice de la clave entre 0 y el número de estados, o SOLVER_NOT_FOUND.
+    // Una clave que no se usó al construir puede dar cualquier índice
+    template <class Key>
+    uint64_t index(Key key) const;
+
+private:
+    const SolverFileHeader* header = nullptr;
+    const uint64_t* words = nullptr;
+    const uint64_t* ranks = nullptr;
+};
+
+inline void PerfectHash::attach(const SolverFileHeader& header, const uint64_t* words, const uint64_t* ranks) {
+    this->header = &header;
+    this->words = words;
+    this->ranks = ranks;
+}
+
+template <class Key>
+inline uint64_t PerfectHash::index(Key key) const {
+    for (uint32_t level = 0; level < header->hashLevels; level++) {
+        uint64_t bit = header->levelWord[level] * 64 + solverHashSlot(key, level, header->levelBits[level]);
+        uint64_t word = bit / 64;
+        uint64_t mask = Bitboard(1) << (bit % 64);
+        if (!(words[word] & mask)) {
+            continue;
+        }
+        uint64_t rank = ranks[word / 8] + popCount(words[word] & (mask - 1));
+        for (uint64_t w = word & ~uint64_t(7); w < word; w++) {
+            rank += popCount(words[w]);
+        }
+        return rank;
+    }
+    return SOLVER_NOT_FOUND;
+}
+
+// Construye el hash perfecto de count claves distintas. Cada nivel coloca las
+// claves que no chocan con otra y pasa las demás al siguiente
+template <class Key>
+bool buildPerfectHash(const Key* keys, uint64_t count, int threads, SolverFileHeader& header,
+                      vector<uint64_t>& words, vector<uint64_t>& ranks) {
+    words.clear();
+    header.hashLevels = 0;
+    uint64_t remaining = count;
+    PerfectHash hash;
+
+    while (remaining > 0) {
+        if (header.hashLevels == SOLVER_MAX_HASH_LEVELS) {
+            return false;
+        }
+        uint32_t level = header.hashLevels;
+        uint64_t bits = max<uint64_t>(64, (static_cast<uint64_t>(remaining * SOLVER_HASH_GAMMA) + 63) / 64 * 64);
+        vector<uint64_t> seen(bits / 64);
+        vector<uint64_t> collided(bits / 64);
+
+        // Las claves ya colocadas se reconocen con los niveles anteriores
+        ranks.assign(words.size() / 8 + 1, 0);
+        hash.attach(header, words.data(), ranks.data());
+        atomic<uint64_t> next{0};
+        auto mark = [&]() {
+            const uint64_t chunk = 4096;
+            for (uint64_t start = next.fetch_add(chunk); start < count; start = next.fetch_add(chunk)) {
+                for (uint64_t i = start; i < min(count, start + chunk); i++) {
+                    if (hash.index(keys[i]) != SOLVER_NOT_FOUND) {
+                        continue;
+                    }
+                    uint64_t slot = solverHashSlot(keys[i], level, bits);
+                    uint64_t mask = Bitboard(1) << (slot % 64);
+                    if (__atomic_fetch_or(&seen[slot / 64], mask, __ATOMIC_RELAXED) & mask) {
+                        __atomic_fetch_or(&collided[slot / 64], mask, __ATOMIC_RELAXED);
+                    }
+                }
+            }
+        };
+        vector<thread> helpers;
+        for (int t = 1; t < threads; t++) {
+            helpers.emplace_back(mark);
+        }
+        mark();
+        for (thread& helper : helpers) {
+            helper.join();
+        }
+
+        header.levelBits[level] = bits;
+        header.levelWord[level] = words.size();
+        header.hashLevels++;
+        for (size_t w = 0; w < seen.size(); w++) {
+            uint64_t placed = seen[w] & ~collided[w];
+            words.push_back(placed);
+            remaining -= popCount(placed);
+        }
+    }
+
+    header.hashWords = words.size();
+    ranks.assign((words.size() + 7) / 8, 0);
+    uint64_t total = 0;
+    for (size_t w = 0; w < words.size(); w++) {
+        if (w % 8 == 0) {
+            ranks[w / 8] = total;
+        }
+        total += popCount(words[w]);
+    }
+    return total == count;
+}
+
+// Clase MappedFile: archivo proyectado en memoria, de solo lectura o creado
+// para escribir
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool openRead(const string& path);
+    // Crea (o trunca) el archivo con length bytes en cero y lo proyecta
+    bool create(const string& path, size_t length);
+    // Espera a que lo escrito llegue al disco
+    void sync();
+    void close();
+
+    uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    uint8_t* bytes = nullptr;
+    size_t length = 0;
+    bool writable = false;
+
+    bool map(int fd, size_t size, bool write);
+};
+
+inline bool MappedFile::map(int fd, size_t size, bool write) {
+    length = size;
+    writable = write;
+    if (size == 0) {
+        ::close(fd);
+        return true;
+    }
+    void* mapped = mmap(nullptr, size, write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        length = 0;
+        return false;
+    }
+    bytes = static_cast<uint8_t*>(mapped);
+    return true;
+}
+
+inline bool MappedFile::openRead(const string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    return map(fd, static_cast<size_t>(info.st_size), false);
+}
+
+inline bool MappedFile::create(const string& path, size_t size) {
+    close();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    return map(fd, size, true);
+}
+
+inline void MappedFile::sync() {
+    if (bytes && writable) {
+        msync(bytes, length, MS_SYNC);
+    }
+}
+
+inline void MappedFile::close() {
+    if (bytes) {
+        sync();
+        munmap(bytes, length);
+        bytes = nullptr;
+    }
+    length = 0;
+}
+
+// Escritor con búfer de un archivo de claves
+template <class Key>
+class KeyFileWriter {
+public:
+    ~KeyFileWriter() { close(); }
+
+    bool open(const string& path) {
+        file = fopen(path.c_str(), "wb");
+        buffer.clear();
+        count = 0;
+        ok = file != nullptr;
+        return ok;
+    }
+    void push(Key key) {
+        if (!file) {
+            return;
+        }
+        buffer.push_back(key);
+        count++;
+        if (buffer.size() == BUFFER_KEYS) {
+            flush();
+        }
+    }
+    // Cierra el archivo; false si alguna escritura falló
+    bool close() {
+        if (file) {
+            flush();
+            ok = fclose(file) == 0 && ok;
+            file = nullptr;
+        }
+        return ok;
+    }
+    uint64_t written() const { return count; }
+
+private:
+    static const size_t BUFFER_KEYS = 1 << 16;
+    FILE* file = nullptr;
+    vector<Key> buffer;
+    uint64_t count = 0;
+    bool ok = false;
+
+    void flush() {
+        if (!buffer.empty() && fwrite(buffer.data(), sizeof(Key), buffer.size(), file) != buffer.size()) {
+            ok = false;
+        }
+        buffer.clear();
+    }
+};
+
+struct SolverOptions {
+    int threads = 1;
+    // Memoria para los tramos de claves antes de volcarlos a disco
+    size_t memoryMb = 256;
+};
+
+// Clase Solver: construye la base de una variante desde una raíz
+template <int N, int Supply>
+class Solver {
+public:
+    using PositionType = BasicPosition<N, Supply>;
+    using Codec = SolverCodec<N>;
+    using Key = typename Codec::Key;
+
+    SolverOptions options;
+    // Recibe una línea de progreso por nivel y por pasada
+    function<void(const string&)> onProgress;
+
+    // Resuelve todos los estados alcanzables desde root y escribe la base en
+    // path. Usa archivos temporales junto a path
+    bool solve(const PositionType& root, const string& path);
+
+private:
+    string path;
+
+    bool enumerate(Key root);
+    bool expandLevel(const Key* frontier, uint64_t count, vector<string>& runs);
+    bool mergeLevel(const vector<string>& runs, uint64_t& added, uint64_t& total);
+    bool analyze(SolverFileHeader& header, uint8_t* base, const Key* keys);
+    // Ejecuta body(primero, último) sobre tramos de [0, count) con todos los hilos
+    template <class Body>
+    void parallelFor(uint64_t count, Body body);
+    void report(const string& line) {
+        if (onProgress) {
+            onProgress(line);
+        }
+    }
+    string tempPath(const string& name) const { return path + "." + name; }
+};
+
+template <int N, int Supply>
+template <class Body>
+inline void Solver<N, Supply>::parallelFor(uint64_t count, Body body) {
+    const uint64_t chunk = 1024;
+    atomic<uint64_t> next{0};
+    auto work = [&]() {
+        for (uint64_t start = next.fetch_add(chunk); start < count; start = next.fetch_add(chunk)) {
+            body(start, min(count, start + chunk));
+        }
+    };
+    vector<thread> helpers;
+    for (int t = 1; t < options.threads; t++) {
+        helpers.emplace_back(work);
+    }
+    work();
+    for (thread& helper : helpers) {
+        helper.join();
+    }
+}
+
+template <int N, int Supply>
+inline bool Solver<N, Supply>::solve(const PositionType& root, const string& target) {
+    path = target;
+    if (root.gameOver) {
+        report("La raíz ya es una partida terminada");
+        return false;
+    }
+    Key rootKey = Codec::encode(root);
+    if (!enumerate(rootKey)) {
+        return false;
+    }
+
+    MappedFile keysFile;
+    if (!keysFile.openRead(tempPath("vistos"))) {
+        report("No se pudo leer la lista de estados");
+        return false;
+    }
+    const Key* keys = reinterpret_cast<const Key*>(keysFile.data());
+    uint64_t count = keysFile.size() / sizeof(Key);
+
+    SolverFileHeader header = {};
+    memcpy(header.magic, SOLVER_MAGIC, sizeof(SOLVER_MAGIC));
+    header.version = SOLVER_VERSION;
+    header.boardSize = N;
+    header.supply = Supply;
+    header.states = count;
+    header.rootKey[0] = static_cast<uint64_t>(rootKey);
+    header.rootKey[1] = static_cast<uint64_t>(static_cast<unsigned __int128>(rootKey) >> 64);
+    vector<uint64_t> words;
+    vector<uint64_t> ranks;
+    if (!buildPerfectHash(keys, count, options.threads, header, words, ranks)) {
+        report("No se pudo construir el hash perfecto");
+        return false;
+    }
+    char bitsPerState[32];
+    snprintf(bitsPerState, sizeof(bitsPerState), "%.2f", count > 0 ? words.size() * 64.0 / count : 0.0);
+    report("Hash perfecto: " + to_string(header.hashLevels) + " niveles, " + bitsPerState + " bits por estado");
+
+    SolverLayout layout = solverLayout(header);
+    MappedFile database;
+    if (!database.create(path, layout.total)) {
+        report("No se pudo crear la base: " + path);
+        return false;
+    }
+    uint8_t* base = database.data();
+    memcpy(base + layout.words, words.data(), words.size() * sizeof(uint64_t));
+    memcpy(base + layout.ranks, ranks.data(), ranks.size() * sizeof(uint64_t));
+
+    if (!analyze(header, base, keys)) {
+        return false;
+    }
+    memcpy(base, &header, sizeof(header));
+    database.close();
+    keysFile.close();
+    unlink(tempPath("vistos").c_str());
+    return true;
+}
+
+// Recorrido en anchura. vistos tiene todas las claves encontradas y frontera
+// las del último nivel, ambas ordenadas
+template <int N, int Supply>
+inline bool Solver<N, Supply>::enumerate(Key root) {
+    for (const char* name : {"vistos", "frontera"}) {
+        KeyFileWriter<Key> writer;
+        writer.open(tempPath(name));
+        writer.push(root);
+        if (!writer.close()) {
+            report("No se pudo escribir " + tempPath(name));
+            return false;
+        }
+    }
+
+    uint64_t total = 1;
+    for (int level = 1;; level++) {
+        vector<string> runs;
+        {
+            MappedFile frontier;
+            if (!frontier.openRead(tempPath("frontera"))) {
+                report("No se pudo leer la frontera");
+                return false;
+            }
+            uint64_t count = frontier.size() / sizeof(Key);
+            if (count == 0) {
+                break;
+            }
+            if (!expandLevel(reinterpret_cast<const Key*>(frontier.data()), count, runs)) {
+                return false;
+            }
+        }
+        uint64_t added = 0;
+        bool merged = mergeLevel(runs, added, total);
+        for (const string& run : runs) {
+            unlink(run.c_str());
+        }
+        if (!merged) {
+            return false;
+        }
+        report("Nivel " + to_string(level) + ": " + to_string(added) + " estados nuevos, " + to_string(total) +
+               " en total");
+    }
+    unlink(tempPath("frontera").c_str());
+    return true;
+}
+
+// Genera los sucesores de la frontera en tramos ordenados y sin repetidos.
+// Las partidas terminadas no se guardan: su valor se conoce al jugar
+template <int N, int Supply>
+inline bool Solver<N, Supply>::expandLevel(const Key* frontier, uint64_t count, vector<string>& runs) {
+    const size_t runKeys = max<size_t>(1 << 16, options.memoryMb * 1024 * 1024 / sizeof(Key) / options.threads);
+    mutex runsMutex;
+    bool ok = true;
+
+    auto writeRun = [&](vector<Key>& buffer) {
+        sort(buffer.begin(), buffer.end());
+        buffer.erase(unique(buffer.begin(), buffer.end()), buffer.end());
+        string name;
+        {
+            lock_guard<mutex> lock(runsMutex);
+            name = tempPath("tramo" + to_string(runs.size()));
+            runs.push_back(name);
+        }
+        KeyFileWriter<Key> writer;
+        bool written = writer.open(name);
+        for (Key key : buffer) {
+            writer.push(key);
+        }
+        if (!writer.close() || !written) {
+            lock_guard<mutex> lock(runsMutex);
+            ok = false;
+        }
+        buffer.clear();
+    };
+
+    atomic<uint64_t> next{0};
+    auto work = [&]() {
+        unique_ptr<PositionType> pos(new PositionType());
+        vector<Key> buffer;
+        buffer.reserve(runKeys);
+        MoveList moves;
+        const uint64_t chunk = 1024;
+        for (uint64_t start = next.fetch_add(chunk); start < count; start = next.fetch_add(chunk)) {
+            for (uint64_t i = start; i < min(count, start + chunk); i++) {
+                Codec::decode(frontier[i], *pos);
+                generateMoves(*pos, moves);
+                for (const Move& move : moves) {
+                    pos->makeMove(move);
+                    if (!pos->gameOver) {
+                        buffer.push_back(Codec::encode(*pos));
+                    }
+                    pos->unmakeMove();
+                }
+                if (buffer.size() + MAX_MOVES > runKeys) {
+                    writeRun(buffer);
+                }
+            }
+        }
+        if (!buffer.empty()) {
+            writeRun(buffer);
+        }
+    };
+    vector<thread> helpers;
+    for (int t = 1; t < options.threads; t++) {
+        helpers.emplace_back(work);
+    }
+    work();
+    for (thread& helper : helpers) {
+        helper.join();
+    }
+    if (!ok) {
+        report("No se pudo escribir un tramo de claves");
+    }
+    return ok;
+}
+
+// Mezcla los tramos con vistos: las claves que no estaban forman la nueva
+// frontera y se agregan a vistos
+template <int N, int Supply>
+inline bool Solver<N, Supply>::mergeLevel(const vector<string>& runs, uint64_t& added, uint64_t& total) {
+    vector<unique_ptr<MappedFile>> files;
+    // Posición actual y final de cada tramo
+    vector<const Key*> at;
+    vector<const Key*> end;
+    for (const string& run : runs) {
+        files.emplace_back(new MappedFile());
+        if (!files.back()->openRead(run)) {
+            report("No se pudo leer el tramo " + run);
+            return false;
+        }
+        at.push_back(reinterpret_cast<const Key*>(files.back()->data()));
+        end.push_back(at.back() + files.back()->size() / sizeof(Key));
+    }
+    MappedFile seenFile;
+    if (!seenFile.openRead(tempPath("vistos"))) {
+        report("No se pudo leer la lista de estados");
+        return false;
+    }
+    const Key* seen = reinterpret_cast<const Key*>(seenFile.data());
+    const Key* seenEnd = seen + seenFile.size() / sizeof(Key);
+
+    KeyFileWriter<Key> seenWriter;
+    KeyFileWriter<Key> frontierWriter;
+    bool ok = seenWriter.open(tempPath("vistos.nuevo")) && frontierWriter.open(tempPath("frontera.nuevo"));
+
+    using Head = pair<Key, size_t>;
+    priority_queue<Head, vector<Head>, greater<Head>> heads;
+    for (size_t r = 0; r < at.size(); r++) {
+        if (at[r] != end[r]) {
+            heads.push(Head(*at[r]++, r));
+        }
+    }
+    while (ok && !heads.empty()) {
+        Head head = heads.top();
+        heads.pop();
+        if (at[head.second] != end[head.second]) {
+            heads.push(Head(*at[head.second]++, head.second));
+        }
+        // La misma clave puede venir de varios tramos
+        while (!heads.empty() && heads.top().first == head.first) {
+            size_t r = heads.top().second;
+            heads.pop();
+            if (at[r] != end[r]) {
+                heads.push(Head(*at[r]++, r));
+            }
+        }
+        while (seen != seenEnd && *seen < head.first) {
+            seenWriter.push(*seen++);
+        }
+        if (seen != seenEnd && *seen == head.first) {
+            continue;
+        }
+        seenWriter.push(head.first);
+        frontierWriter.push(head.first);
+    }
+    while (seen != seenEnd) {
+        seenWriter.push(*seen++);
+    }
+    added = frontierWriter.written();
+    total = seenWriter.written();
+    ok = seenWriter.close() && frontierWriter.close() && ok;
+    seenFile.close();
+    if (!ok || rename(tempPath("vistos.nuevo").c_str(), tempPath("vistos").c_str()) != 0 ||
+        rename(tempPath("frontera.nuevo").c_str(), tempPath("frontera").c_str()) != 0) {
+        report("No se pudo escribir la lista de estados");
+        return false;
+    }
+    return true;
+}
+
+// Pasadas de análisis sobre los valores del archivo. Un valor escrito en la
+// pasada k tiene distancia k; los hilos leen los valores de otros estados sin
+// sincronizar y tratan los de distancia k como aún sin resolver, así el
+// resultado no depende del orden
+template <int N, int Supply>
+inline bool Solver<N, Supply>::analyze(SolverFileHeader& header, uint8_t* base, const Key* keys) {
+    SolverLayout layout = solverLayout(header);
+    PerfectHash hash;
+    hash.attach(header, reinterpret_cast<const uint64_t*>(base + layout.words),
+                reinterpret_cast<const uint64_t*>(base + layout.ranks));
+    uint8_t* fingerprints = base + layout.fingerprints;
+    uint16_t* values = reinterpret_cast<uint16_t*>(base + layout.values);
+    const uint64_t count = header.states;
+
+    parallelFor(count, [&](uint64_t first, uint64_t last) {
+        for (uint64_t i = first; i < last; i++) {
+            fingerprints[hash.index(keys[i])] = solverFingerprint(keys[i]);
+        }
+    });
+
+    header.passes = 0;
+    for (int pass = 1; pass <= SOLVER_MAX_DISTANCE; pass++) {
+        atomic<uint64_t> resolved{0};
+        parallelFor(count, [&](uint64_t first, uint64_t last) {
+            unique_ptr<PositionType> pos(new PositionType());
+            MoveList moves;
+            uint64_t found = 0;
+            for (uint64_t i = first; i < last; i++) {
+                uint64_t index = hash.index(keys[i]);
+                if (__atomic_load_n(&values[index], __ATOMIC_RELAXED) != 0) {
+                    continue;
+                }
+                Codec::decode(keys[i], *pos);
+                generateMoves(*pos, moves);
+                int mover = pos->sideToMove;
+                // Menor distancia a un sucesor perdido y mayor a uno ganado
+                int winIn = 0;
+                int lossIn = 0;
+                bool allWon = !moves.empty();
+                for (const Move& move : moves) {
+                    pos->makeMove(move);
+                    int distance = -1;
+                    bool childWins = false;
+                    if (pos->gameOver) {
+                        distance = 0;
+                        childWins = pos->winner != mover;
+                    } else {
+                        uint64_t child = hash.index(Codec::encode(*pos));
+                        uint16_t value = child == SOLVER_NOT_FOUND ? 0 : __atomic_load_n(&values[child], __ATOMIC_RELAXED);
+                        if (value != 0 && (value & SOLVER_MAX_DISTANCE) < pass) {
+                            distance = value & SOLVER_MAX_DISTANCE;
+                            childWins = !(value & SOLVER_LOSS_FLAG);
+                        }
+                    }
+                    pos->unmakeMove();
+
+                    if (distance >= 0 && !childWins) {
+                        winIn = winIn == 0 ? distance + 1 : min(winIn, distance + 1);
+                        allWon = false;
+                    } else if (distance >= 0) {
+                        lossIn = max(lossIn, distance + 1);
+                    } else {
+                        allWon = false;
+                    }
+                }
+                uint16_t value = winIn > 0 ? static_cast<uint16_t>(winIn)
+                                           : allWon ? static_cast<uint16_t>(SOLVER_LOSS_FLAG | lossIn) : 0;
+                if (value != 0) {
+                    __atomic_store_n(&values[index], value, __ATOMIC_RELAXED);
+                    found++;
+                }
+            }
+            resolved += found;
+        });
+
+        report("Pasada " + to_string(pass) + ": " + to_string(resolved.load()) + " estados resueltos");
+        if (resolved == 0) {
+            break;
+        }
+        header.passes = pass;
+    }
+    if (header.passes == SOLVER_MAX_DISTANCE) {
+        report("Distancia máxima alcanzada: la base queda incompleta");
+    }
+
+    header.wins = header.losses = header.draws = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        SolverValue value = decodeSolverValue(values[i]);
+        header.wins += value.result == SolverResult::WIN;
+        header.losses += value.result == SolverResult::LOSS;
+        header.draws += value.result == SolverResult::DRAW;
+    }
+    header.complete = header.passes < SOLVER_MAX_DISTANCE;
+    return true;
+}
+
+// Clase SolverDatabase: consultas de juego perfecto sobre una base ya hecha
+class SolverDatabase {
+public:
+    bool open(const string& path);
+    void close() { file.close(); }
+    const SolverFileHeader& header() const { return *reinterpret_cast<const SolverFileHeader*>(file.data()); }
+
+    template <int N, int Supply>
+    bool matches() const {
+        return header().boardSize == N && header().supply == Supply;
+    }
+    // Posición desde la que se resolvió la base
+    template <int N, int Supply>
+    void root(BasicPosition<N, Supply>& pos) const;
+    // Valor de la posición para el que mueve. Las partidas terminadas también
+    // se responden; las posiciones que no alcanza la raíz dan UNKNOWN
+    template <int N, int Supply>
+    SolverValue probe(const BasicPosition<N, Supply>& pos) const;
+    // Valor que deja cada jugada, desde el punto de vista del que la hace
+    template <int N, int Supply>
+    SolverValue probeMove(BasicPosition<N, Supply>& pos, const Move& move) const;
+    // Mejor jugada: la victoria más corta, si no unas tablas, si no la derrota
+    // más larga. False si no hay jugadas o la posición no está en la base
+    template <int N, int Supply>
+    bool bestMove(BasicPosition<N, Supply>& pos, Move& best, SolverValue& value) const;
+
+private:
+    MappedFile file;
+    PerfectHash hash;
+    const uint8_t* fingerprints = nullptr;
+    const uint16_t* values = nullptr;
+};
+
+inline bool SolverDatabase::open(const string& path) {
+    if (!file.openRead(path) || file.size() < sizeof(SolverFileHeader)) {
+        file.close();
+        return false;
+    }
+    const SolverFileHeader& h = header();
+    if (memcmp(h.magic, SOLVER_MAGIC, sizeof(SOLVER_MAGIC)) != 0 || h.version != SOLVER_VERSION ||
+        h.hashLevels > SOLVER_MAX_HASH_LEVELS || solverLayout(h).total != file.size()) {
+        file.close();
+        return false;
+    }
+    SolverLayout layout = solverLayout(h);
+    hash.attach(h, reinterpret_cast<const uint64_t*>(file.data() + layout.words),
+                reinterpret_cast<const uint64_t*>(file.data() + layout.ranks));
+    fingerprints = file.data() + layout.fingerprints;
+    values = reinterpret_cast<const uint16_t*>(file.data() + layout.values);
+    return true;
+}
+
+template <int N, int Supply>
+inline void SolverDatabase::root(BasicPosition<N, Supply>& pos) const {
+    using Key = typename SolverCodec<N>::Key;
+    unsigned __int128 key = (static_cast<unsigned __int128>(header().rootKey[1]) << 64) | header().rootKey[0];
+    SolverCodec<N>::decode(static_cast<Key>(key), pos);
+}
+
+template <int N, int Supply>
+inline SolverValue SolverDatabase::probe(const BasicPosition<N, Supply>& pos) const {
+    SolverValue value;
+    if (!matches<N, Supply>()) {
+        return value;
+    }
+    if (pos.gameOver) {
+        value.result = pos.winner == pos.sideToMove ? SolverResult::WIN : SolverResult::LOSS;
+        return value;
+    }
+    typename SolverCodec<N>::Key key = SolverCodec<N>::encode(pos);
+    uint64_t index = hash.index(key);
+    if (index == SOLVER_NOT_FOUND || fingerprints[index] != solverFingerprint(key)) {
+        return value;
+    }
+    return decodeSolverValue(values[index]);
+}
+
+template <int N, int Supply>
+inline SolverValue SolverDatabase::probeMove(BasicPosition<N, Supply>& pos, const Move& move) const {
+    int mover = pos.sideToMove;
+    pos.makeMove(move);
+    SolverValue value = probe(pos);
+    // El turno no pasa al ganar: una partida terminada ya está vista desde el
+    // que movió. Si no, se da vuelta el resultado del rival
+    if (pos.gameOver) {
+        value.result = pos.winner == mover ? SolverResult::WIN : SolverResult::LOSS;
+        value.plies = 1;
+    } else if (value.result == SolverResult::WIN || value.result == SolverResult::LOSS) {
+        value.result = value.result == SolverResult::WIN ? SolverResult::LOSS : SolverResult::WIN;
+        value.plies++;
+    }
+    pos.unmakeMove();
+    return value;
+}
+
+template <int N, int Supply>
+inline bool SolverDatabase::bestMove(BasicPosition<N, Supply>& pos, Move& best, SolverValue& value) const {
+    MoveList moves;
+    generateMoves(pos, moves);
+    bool found = false;
+    // Orden de preferencia: ganar pronto, tablas, perder tarde
+    auto rank = [](const SolverValue& v) {
+        switch (v.result) {
+            case SolverResult::WIN:
+                return 2 * SOLVER_MAX_DISTANCE - v.plies;
+            case SolverResult::DRAW:
+                return SOLVER_MAX_DISTANCE;
+            default:
+                return v.plies;
+        }
+    };
+    for (const Move& move : moves) {
+        SolverValue candidate = probeMove(pos, move);
+        if (candidate.result == SolverResult::UNKNOWN) {
+            return false;
+        }
+        if (!found || rank(candidate) > rank(value)) {
+            best = move;
+            value = candidate;
+            found = true;
+        }
+    }
+    return found;
+}
+
+#endif // BOOPSOLVER_H
@@ -0,0 +1,179 @@
+#ifndef BOOPSYMMETRY_H
+#define BOOPSYMMETRY_H
+
+#include <cstdint>
+
+#include "BoopPosition.h"
+
+// Las 8 simetrías del tablero cuadrado (rotaciones y reflejos). Las casillas
+// se transforman con una tabla por simetría y las máscaras con una tabla por
+// byte: cada byte de la máscara se convierte de una vez en sus casillas
+// transformadas.
+//
+// La forma canónica de una posición es la de menor clave Zobrist entre sus 8
+// orientaciones. Los vecinos del boop y las líneas de tres son simétricos,
+// pero cuando una jugada completa dos líneas que se solapan se gradúa la
+// primera en el orden de la tabla de líneas, y ese orden no es simétrico.
+// Por eso dos posiciones simétricas pueden tener valores distintos en esos
+// casos raros: la clave canónica sirve para compartir información
+// (tablas de transposición, libros, deduplicación), no como prueba de igualdad.
+
+const int NUM_SYMMETRIES = 8;
+
+// Orden de las simetrías
+enum Symmetry {
+    SYM_IDENTITY,
+    SYM_ROTATE_90,      // en sentido horario
+    SYM_ROTATE_180,
+    SYM_ROTATE_270,
+    SYM_MIRROR,         // refleja las columnas
+    SYM_FLIP,           // refleja las filas
+    SYM_TRANSPOSE,      // diagonal principal
+    SYM_ANTI_TRANSPOSE  // diagonal secundaria
+};
+
+// Simetría que deshace a la dada
+constexpr int inverseSymmetry(int symmetry) {
+    return symmetry == SYM_ROTATE_90 ? SYM_ROTATE_270 : symmetry == SYM_ROTATE_270 ? SYM_ROTATE_90 : symmetry;
+}
+
+template <int N>
+struct SymmetryTable {
+    static constexpr int BYTES = (N * N + 7) / 8;
+
+    uint8_t square[NUM_SYMMETRIES][N * N];
+    Bitboard byteMask[NUM_SYMMETRIES][BYTES][256];
+};
+
+template <int N>
+constexpr int transformSquare(int symmetry, int sq) {
+    int row = sq / N;
+    int col = sq % N;
+    switch (symmetry) {
+        case SYM_ROTATE_90:
+            return col * N + (N - 1 - row);
+        case SYM_ROTATE_180:
+            return (N - 1 - row) * N + (N - 1 - col);
+        case SYM_ROTATE_270:
+            return (N - 1 - col) * N + row;
+        case SYM_MIRROR:
+            return row * N + (N - 1 - col);
+        case SYM_FLIP:
+            return (N - 1 - row) * N + col;
+        case SYM_TRANSPOSE:
+            return col * N + row;
+        case SYM_ANTI_TRANSPOSE:
+            return (N - 1 - col) * N + (N - 1 - row);
+        default:
+            return sq;
+    }
+}
+
+template <int N>
+constexpr SymmetryTable<N> makeSymmetryTable() {
+    SymmetryTable<N> table{};
+    for (int s = 0; s < NUM_SYMMETRIES; s++) {
+        for (int sq = 0; sq < N * N; sq++) {
+            table.square[s][sq] = static_cast<uint8_t>(transformSquare<N>(s, sq));
+        }
+        for (int b = 0; b < SymmetryTable<N>::BYTES; b++) {
+            for (int value = 0; value < 256; value++) {
+                Bitboard mask = 0;
+                for (int bit = 0; bit < 8; bit++) {
+                    int sq = b * 8 + bit;
+                    if ((value >> bit) & 1 && sq < N * N) {
+                        mask |= squareBit(table.square[s][sq]);
+                    }
+                }
+                table.byteMask[s][b][value] = mask;
+            }
+        }
+    }
+    return table;
+}
+
+template <int N>
+inline constexpr SymmetryTable<N> SYMMETRY_TABLE = makeSymmetryTable<N>();
+
+static_assert(transformSquare<BOARD_SIZE>(SYM_ROTATE_90, squareOf(0, 0)) == squareOf(0, 5), "rotación de 90");
+static_assert(transformSquare<BOARD_SIZE>(SYM_ANTI_TRANSPOSE, squareOf(0, 1)) == squareOf(4, 5), "diagonal secundaria");
+static_assert(transformSquare<BOARD_SIZE>(inverseSymmetry(SYM_ROTATE_90),
+                                          transformSquare<BOARD_SIZE>(SYM_ROTATE_90, squareOf(1, 4))) == squareOf(1, 4),
+              "inversa de la rotación");
+
+template <int N>
+inline Bitboard transformMask(Bitboard mask, int symmetry) {
+    const SymmetryTable<N>& table = SYMMETRY_TABLE<N>;
+    Bitboard result = 0;
+    for (int b = 0; b < SymmetryTable<N>::BYTES; b++) {
+        result |= table.byteMask[symmetry][b][(mask >> (b * 8)) & 0xFF];
+    }
+    return result;
+}
+
+template <int N>
+inline BasicBitBoard<N> transformBoard(const BasicBitBoard<N>& board, int symmetry) {
+    BasicBitBoard<N> result;
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            result.pieces[p][t] = transformMask<N>(board.pieces[p][t], symmetry);
+        }
+    }
+    return result;
+}
+
+template <int N = BOARD_SIZE>
+inline Move transformMove(const Move& move, int symmetry) {
+    return Move(SYMMETRY_TABLE<N>.square[symmetry][move.square], move.type);
+}
+
+// Clave canónica y simetría que lleva la posición a su forma canónica
+struct CanonicalKey {
+    uint64_t key = 0;
+    int symmetry = SYM_IDENTITY;
+};
+
+// Claves Zobrist de la posición en cada orientación. Las reservas y el turno
+// no cambian con la simetría: solo se recalcula la parte de las piezas
+template <int N, int Supply>
+inline void symmetryKeys(const BasicPosition<N, Supply>& pos, uint64_t keys[NUM_SYMMETRIES]) {
+    const SymmetryTable<N>& table = SYMMETRY_TABLE<N>;
+    for (int s = 0; s < NUM_SYMMETRIES; s++) {
+        keys[s] = 0;
+    }
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            const uint64_t* pieceKeys = ZOBRIST.piece[p][t];
+            Bitboard pieces = pos.board.pieces[p][t];
+            while (pieces) {
+                int sq = popLsb(pieces);
+                for (int s = 0; s < NUM_SYMMETRIES; s++) {
+                    keys[s] ^= pieceKeys[table.square[s][sq]];
+                }
+            }
+        }
+    }
+
+    // keys[SYM_IDENTITY] es la parte de las piezas de pos.key
+    uint64_t rest = pos.key ^ keys[SYM_IDENTITY];
+    for (int s = 0; s < NUM_SYMMETRIES; s++) {
+        keys[s] ^= rest;
+    }
+}
+
+template <int N, int Supply>
+inline CanonicalKey canonicalKey(const BasicPosition<N, Supply>& pos) {
+    uint64_t keys[NUM_SYMMETRIES];
+    symmetryKeys(pos, keys);
+    CanonicalKey best;
+    best.key = keys[SYM_IDENTITY];
+    for (int s = 1; s < NUM_SYMMETRIES; s++) {
+        if (keys[s] < best.key) {
+            best.key = keys[s];
+            best.symmetry = s;
+        }
+    }
+    return best;
+}
+
+#endif // BOOPSYMMETRY_H
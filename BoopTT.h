@@ -0,0 +1,225 @@
+#ifndef BOOPTT_H
+#define BOOPTT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "BoopPosition.h"
+
+// Tabla de transposición de tamaño fijo para posiciones de Boop.
+// Las entradas se agrupan en cubetas de 64 bytes (una línea de caché), así
+// que cada consulta toca una sola línea de memoria.
+// La tabla se comparte entre hilos sin candados: cada entrada son dos palabras
+// atómicas, la clave XOR los datos y los datos. Una escritura a medias de otro
+// hilo no pasa la verificación y se trata como un fallo de consulta.
+
+enum class Bound : uint8_t {
+    NONE = 0,
+    EXACT = 1,
+    LOWER = 2,
+    UPPER = 3
+};
+
+// Entrada decodificada
+struct TTEntry {
+    uint64_t key = 0;
+    int16_t score = 0;
+    uint8_t moveSquare = OFF_BOARD;
+    uint8_t moveType = 0;
+    int8_t depth = 0;
+    Bound bound = Bound::NONE;
+    uint8_t generation = 0;
+    // Orientación de la posición que guardó la entrada respecto a la clave
+    // (BoopSymmetry.h); 0 si la clave es la de la propia posición
+    uint8_t symmetry = 0;
+
+    bool hasMove() const { return moveSquare != OFF_BOARD; }
+    Move move() const { return Move(moveSquare, typeFromIndex(moveType)); }
+
+    uint64_t pack() const;
+    static TTEntry unpack(uint64_t key, uint64_t data);
+};
+
+inline uint64_t TTEntry::pack() const {
+    return uint64_t(uint16_t(score)) |
+           uint64_t(moveSquare) << 16 |
+           uint64_t(moveType) << 24 |
+           uint64_t(uint8_t(depth)) << 32 |
+           uint64_t(bound) << 40 |
+           uint64_t(generation) << 48 |
+           uint64_t(symmetry) << 56;
+}
+
+inline TTEntry TTEntry::unpack(uint64_t key, uint64_t data) {
+    TTEntry entry;
+    entry.key = key;
+    entry.score = static_cast<int16_t>(data & 0xFFFF);
+    entry.moveSquare = static_cast<uint8_t>(data >> 16);
+    entry.moveType = static_cast<uint8_t>(data >> 24);
+    entry.depth = static_cast<int8_t>(data >> 32);
+    entry.bound = static_cast<Bound>((data >> 40) & 0xFF);
+    entry.generation = static_cast<uint8_t>(data >> 48);
+    entry.symmetry = static_cast<uint8_t>(data >> 56);
+    return entry;
+}
+
+// Entrada guardada de 16 bytes
+struct TTSlot {
+    std::atomic<uint64_t> keyXorData{0};
+    std::atomic<uint64_t> data{0};
+
+    TTEntry load() const {
+        uint64_t d = data.load(std::memory_order_relaxed);
+        uint64_t k = keyXorData.load(std::memory_order_relaxed) ^ d;
+        return TTEntry::unpack(k, d);
+    }
+
+    void save(const TTEntry& entry) {
+        uint64_t d = entry.pack();
+        keyXorData.store(entry.key ^ d, std::memory_order_relaxed);
+        data.store(d, std::memory_order_relaxed);
+    }
+};
+
+const int TT_BUCKET_SIZE = 4;
+
+struct alignas(64) TTBucket {
+    TTSlot entries[TT_BUCKET_SIZE];
+};
+
+// Clase TranspositionTable
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes = 16);
+    void resize(size_t megabytes);
+    void clear();
+    void newSearch();
+    bool probe(uint64_t key, TTEntry& entry) const;
+    void store(uint64_t key, const Move* move, int score, int depth, Bound bound, int symmetry = 0);
+    size_t capacity() const { return bucketCount * TT_BUCKET_SIZE; }
+    int hashfull() const;
+
+private:
+    std::unique_ptr<TTBucket[]> buckets;
+    size_t bucketCount = 0;
+    uint64_t bucketMask = 0;
+    std::atomic<uint8_t> generation{0};
+
+    TTBucket& bucketFor(uint64_t key) { return buckets[key & bucketMask]; }
+    const TTBucket& bucketFor(uint64_t key) const { return buckets[key & bucketMask]; }
+};
+
+inline TranspositionTable::TranspositionTable(size_t megabytes) {
+    resize(megabytes);
+}
+
+// Usa la mayor potencia de dos de cubetas que cabe en el presupuesto
+inline void TranspositionTable::resize(size_t megabytes) {
+    size_t bytes = (megabytes > 0 ? megabytes : 1) * 1024 * 1024;
+    size_t count = 1;
+    while (count * 2 * sizeof(TTBucket) <= bytes) {
+        count *= 2;
+    }
+    buckets.reset(new TTBucket[count]);
+    bucketCount = count;
+    bucketMask = count - 1;
+    generation = 0;
+}
+
+inline void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucketCount; i++) {
+        for (TTSlot& slot : buckets[i].entries) {
+            slot.keyXorData.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+// Marca el comienzo de una búsqueda nueva para envejecer las entradas viejas
+inline void TranspositionTable::newSearch() {
+    generation++;
+}
+
+inline bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const TTBucket& bucket = bucketFor(key);
+    for (const TTSlot& slot : bucket.entries) {
+        TTEntry candidate = slot.load();
+        if (candidate.key == key && candidate.bound != Bound::NONE) {
+            entry = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reemplazo: se reutiliza la entrada de la misma posición; si no hay, se
+// sustituye la de menor valor, donde cuentan la profundidad y la antigüedad
+inline void TranspositionTable::store(uint64_t key, const Move* move, int score, int depth, Bound bound,
+                                      int symmetry) {
+    TTBucket& bucket = bucketFor(key);
+    uint8_t currentGeneration = generation.load(std::memory_order_relaxed);
+    TTSlot* target = &bucket.entries[0];
+    TTEntry old = target->load();
+    int worstValue = 1 << 30;
+
+    for (TTSlot& slot : bucket.entries) {
+        TTEntry candidate = slot.load();
+        if (candidate.key == key || candidate.bound == Bound::NONE) {
+            target = &slot;
+            old = candidate;
+            break;
+        }
+        int age = static_cast<uint8_t>(currentGeneration - candidate.generation);
+        int value = candidate.depth - 4 * age;
+        if (value < worstValue) {
+            worstValue = value;
+            target = &slot;
+            old = candidate;
+        }
+    }
+
+    // No se pisa un resultado más profundo de la misma posición, orientación
+    // y búsqueda, salvo que sea exacto
+    if (old.key == key && old.symmetry == symmetry && old.generation == currentGeneration &&
+        old.depth > depth && bound != Bound::EXACT) {
+        return;
+    }
+
+    TTEntry entry;
+    entry.key = key;
+    // Se conserva la jugada anterior si la nueva búsqueda no encontró ninguna
+    if (move) {
+        entry.moveSquare = move->square;
+        entry.moveType = static_cast<uint8_t>(typeIndex(move->type));
+    } else if (old.key == key) {
+        entry.moveSquare = old.moveSquare;
+        entry.moveType = old.moveType;
+    }
+    entry.score = static_cast<int16_t>(score);
+    entry.depth = static_cast<int8_t>(depth);
+    entry.bound = bound;
+    entry.generation = currentGeneration;
+    entry.symmetry = static_cast<uint8_t>(symmetry);
+    target->save(entry);
+}
+
+// Ocupación aproximada en milésimas, muestreando las primeras cubetas
+inline int TranspositionTable::hashfull() const {
+    size_t sample = bucketCount < 250 ? bucketCount : 250;
+    uint8_t currentGeneration = generation.load(std::memory_order_relaxed);
+    int used = 0;
+    for (size_t i = 0; i < sample; i++) {
+        for (const TTSlot& slot : buckets[i].entries) {
+            TTEntry entry = slot.load();
+            if (entry.bound != Bound::NONE && entry.generation == currentGeneration) {
+                used++;
+            }
+        }
+    }
+    return static_cast<int>(used * 1000 / (sample * TT_BUCKET_SIZE));
+}
+
+#endif // BOOPTT_H
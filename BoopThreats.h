@@ -0,0 +1,374 @@
+#ifndef BOOPTHREATS_H
+#define BOOPTHREATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "BoopGame.h"
+#include "BoopMoveGen.h"
+
+// Búsqueda de victorias forzadas por amenazas (proof-number search).
+// El que ataca solo prueba jugadas tácticas: las que crean amenazas de línea
+// de tres (casillas como las de CanPromote, de gatitos y de gatos), las que
+// gradúan gatitos y las que deshacen amenazas del rival (ocupando la casilla
+// o sacándole un gatito con el boop). El que defiende prueba todas sus
+// jugadas salvo las que dejan al atacante ganar en la jugada siguiente, que
+// ya están perdidas. Así una victoria encontrada está demostrada contra
+// cualquier defensa, aunque no encontrarla no prueba que no exista.
+//
+// Cada nodo guarda un número de prueba (cuántas hojas faltan, como mínimo,
+// para demostrar la victoria) y uno de refutación; en cada iteración se
+// expande la hoja más prometedora. Los nodos viven en un arreglo y los hijos
+// de un nodo ocupan un bloque contiguo, como en BoopMCTS.h. Las posiciones
+// no se guardan: se rehacen con makeMove/unmakeMove desde la raíz.
+
+const uint32_t THREAT_INFINITY = 1u << 30;
+const int32_t THREAT_NO_NODE = -1;
+// Número de prueba inicial de una respuesta a una jugada que no amenaza
+// ganar: el defensor tiene muchas respuestas y cuesta más demostrarla
+const uint32_t THREAT_QUIET_PROOF = 8;
+
+// Límites de la búsqueda; maxTimeMs 0 es sin límite de tiempo
+struct ThreatLimits {
+    uint64_t maxNodes = 1000000;
+    int64_t maxTimeMs = 0;
+    // Jugadas, de ambos lados, más allá de las cuales no se sigue una línea
+    int maxDepth = 40;
+};
+
+struct ThreatResult {
+    // Victoria demostrada para el que mueve en la raíz
+    bool found = false;
+    // Sin victoria y sin agotar los límites: no hay victoria solo con
+    // jugadas de amenaza dentro de maxDepth
+    bool exhausted = false;
+    // Línea principal: la victoria más corta contra la defensa más larga
+    // dentro del árbol demostrado, terminando en la jugada que gana
+    vector<Move> pv;
+    uint64_t nodes = 0;
+    int64_t timeMs = 0;
+};
+
+struct ThreatNode {
+    Move move;
+    int32_t firstChild = THREAT_NO_NODE;
+    uint16_t childCount = 0;
+    // Respuestas del defensor que se descartaron porque pierden enseguida
+    uint16_t refuted = 0;
+    uint32_t proof = 1;
+    uint32_t disproof = 1;
+    bool expanded = false;
+};
+
+// Casillas donde side gana colocando un gato, si le quedan gatos
+inline Bitboard winningSquares(const Position& pos, const ThreatMap& threats, int side) {
+    return pos.gatos_disponibles[side] > 0 ? threats.squares[side][1] : 0;
+}
+
+// Clase ThreatSearch
+class ThreatSearch {
+public:
+    ThreatLimits limits;
+    // Se consulta junto con el límite de tiempo; si devuelve true la búsqueda
+    // termina sin victoria, como al agotar los límites
+    function<bool()> shouldStop;
+
+    ThreatResult search(const Position& root);
+
+private:
+    vector<ThreatNode> nodes;
+    unique_ptr<Position> pos;
+    int attacker = 0;
+    chrono::steady_clock::time_point startTime;
+
+    void expand(int32_t index, int depth);
+    void expandAttacker();
+    void expandDefender(int32_t index);
+    void addChild(const Move& move, uint32_t proof, uint32_t disproof);
+    void update(int32_t index, bool attackerToMove);
+    // Jugadas hasta ganar dentro del árbol demostrado del nodo
+    int winDistance(int32_t index, bool attackerToMove) const;
+    void extractPV(ThreatResult& result);
+    int64_t elapsedMs() const {
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - startTime).count();
+    }
+};
+
+inline ThreatResult ThreatSearch::search(const Position& root) {
+    ThreatResult result;
+    startTime = chrono::steady_clock::now();
+    if (!pos) {
+        pos.reset(new Position());
+    }
+    *pos = root;
+    pos->clearHistory();
+    attacker = root.sideToMove;
+    nodes.clear();
+    nodes.reserve(min<uint64_t>(limits.maxNodes, 1 << 20) + MAX_MOVES);
+    nodes.emplace_back();
+    if (root.gameOver) {
+        result.exhausted = true;
+        return result;
+    }
+
+    int maxDepth = min(limits.maxDepth, MAX_PLY - 1);
+    vector<int32_t> path;
+    for (uint64_t iteration = 0;; iteration++) {
+        const ThreatNode& top = nodes[0];
+        if (top.proof == 0 || top.disproof == 0) {
+            break;
+        }
+        if (nodes.size() + MAX_MOVES > limits.maxNodes) {
+            break;
+        }
+        if ((iteration & 255) == 0 &&
+            ((limits.maxTimeMs > 0 && elapsedMs() >= limits.maxTimeMs) || (shouldStop && shouldStop()))) {
+            break;
+        }
+
+        // Baja hasta la hoja más prometedora: en los nodos del atacante el
+        // hijo con menor número de prueba, en los del defensor el de menor
+        // número de refutación
+        path.assign(1, 0);
+        int32_t current = 0;
+        while (nodes[current].expanded) {
+            const ThreatNode& node = nodes[current];
+            bool attackerToMove = path.size() % 2 == 1;
+            int32_t best = node.firstChild;
+            for (int32_t child = node.firstChild + 1; child < node.firstChild + node.childCount; child++) {
+                if (attackerToMove ? nodes[child].proof < nodes[best].proof
+                                   : nodes[child].disproof < nodes[best].disproof) {
+                    best = child;
+                }
+            }
+            pos->makeMove(nodes[best].move);
+            path.push_back(best);
+            current = best;
+        }
+
+        int depth = static_cast<int>(path.size()) - 1;
+        if (depth >= maxDepth) {
+            // La línea es demasiado larga: cuenta como no demostrada
+            nodes[current].proof = THREAT_INFINITY;
+            nodes[current].disproof = 0;
+            nodes[current].expanded = true;
+        } else {
+            expand(current, depth);
+        }
+
+        for (int i = depth; i >= 0; i--) {
+            update(path[i], i % 2 == 0);
+            if (i > 0) {
+                pos->unmakeMove();
+            }
+        }
+    }
+
+    result.nodes = nodes.size();
+    result.found = nodes[0].proof == 0;
+    result.exhausted = nodes[0].disproof == 0;
+    if (result.found) {
+        extractPV(result);
+    }
+    result.timeMs = elapsedMs();
+    return result;
+}
+
+inline void ThreatSearch::expand(int32_t index, int depth) {
+    bool attackerToMove = depth % 2 == 0;
+    int32_t first = static_cast<int32_t>(nodes.size());
+    if (attackerToMove) {
+        expandAttacker();
+    } else {
+        expandDefender(index);
+    }
+
+    // Los hijos se agregan al final de nodes, que pudo crecer: el nodo se
+    // vuelve a buscar por su índice
+    ThreatNode& node = nodes[index];
+    node.expanded = true;
+    node.firstChild = first;
+    node.childCount = static_cast<uint16_t>(nodes.size() - first);
+    if (node.childCount == 0) {
+        // El atacante no tiene amenazas, o todas las respuestas del defensor
+        // pierden enseguida
+        node.proof = attackerToMove ? THREAT_INFINITY : 0;
+        node.disproof = attackerToMove ? 0 : THREAT_INFINITY;
+    } else {
+        update(index, attackerToMove);
+    }
+}
+
+inline void ThreatSearch::addChild(const Move& move, uint32_t proof, uint32_t disproof) {
+    ThreatNode child;
+    child.move = move;
+    child.proof = proof;
+    child.disproof = disproof;
+    // Un nodo resuelto no se expande
+    child.expanded = proof == 0 || disproof == 0;
+    nodes.push_back(child);
+}
+
+inline void ThreatSearch::expandAttacker() {
+    int defender = attacker ^ 1;
+    ThreatMap before;
+    findThreats(pos->board, before);
+
+    MoveList moves;
+    generateMoves(*pos, moves);
+
+    // Si se puede ganar ya, no hace falta nada más
+    Bitboard wins = winningSquares(*pos, before, attacker);
+    if (wins) {
+        addChild(Move(popLsb(wins), PieceType::GATO), 0, THREAT_INFINITY);
+        return;
+    }
+
+    bool mustAnswer = winningSquares(*pos, before, defender) != 0;
+    for (const Move& move : moves) {
+        pos->makeMove(move);
+        ThreatMap after;
+        findThreats(pos->board, after);
+
+        bool tactical = mustAnswer;
+        if (!tactical) {
+            int type = typeIndex(move.type);
+            // Crea una amenaza nueva del tipo jugado
+            bool creates = (after.squares[attacker][type] & ~before.squares[attacker][type]) != 0;
+            // Gradúa gatitos
+            bool graduates = pos->gatos_disponibles[attacker] > pos->lastUndo().gatos_disponibles[attacker];
+            // Deshace una amenaza del rival
+            bool answers = (before.squares[defender][0] & ~after.squares[defender][0]) != 0 ||
+                           (before.squares[defender][1] & ~after.squares[defender][1]) != 0;
+            tactical = creates || graduates || answers;
+        }
+        // Las que dejan ganar al rival enseguida ya están perdidas
+        if (tactical && !winningSquares(*pos, after, defender) && !pos->isRepetition()) {
+            bool forcing = winningSquares(*pos, after, attacker) != 0;
+            addChild(move, forcing ? 1 : THREAT_QUIET_PROOF, 1);
+        }
+        pos->unmakeMove();
+    }
+}
+
+inline void ThreatSearch::expandDefender(int32_t index) {
+    MoveList moves;
+    generateMoves(*pos, moves);
+    if (moves.empty()) {
+        // Sin jugadas son tablas
+        addChild(Move(), THREAT_INFINITY, 0);
+        return;
+    }
+
+    for (const Move& move : moves) {
+        pos->makeMove(move);
+        if (pos->gameOver) {
+            if (pos->winner != attacker) {
+                addChild(move, THREAT_INFINITY, 0);
+            }
+        } else {
+            ThreatMap after;
+            findThreats(pos->board, after);
+            if (winningSquares(*pos, after, attacker)) {
+                nodes[index].refuted++;
+            } else if (pos->isRepetition()) {
+                addChild(move, THREAT_INFINITY, 0);
+            } else {
+                addChild(move, 1, 1);
+            }
+        }
+        pos->unmakeMove();
+    }
+}
+
+inline void ThreatSearch::update(int32_t index, bool attackerToMove) {
+    ThreatNode& node = nodes[index];
+    if (node.childCount == 0) {
+        return;
+    }
+
+    uint32_t minimum = THREAT_INFINITY;
+    uint64_t sum = 0;
+    for (int32_t child = node.firstChild; child < node.firstChild + node.childCount; child++) {
+        uint32_t own = attackerToMove ? nodes[child].proof : nodes[child].disproof;
+        uint32_t other = attackerToMove ? nodes[child].disproof : nodes[child].proof;
+        minimum = min(minimum, own);
+        sum += other;
+    }
+    uint32_t total = static_cast<uint32_t>(min<uint64_t>(sum, THREAT_INFINITY));
+    node.proof = attackerToMove ? minimum : total;
+    node.disproof = attackerToMove ? total : minimum;
+}
+
+inline int ThreatSearch::winDistance(int32_t index, bool attackerToMove) const {
+    const ThreatNode& node = nodes[index];
+    if (node.childCount == 0) {
+        // Tras la jugada que gana, o un defensor cuyas respuestas pierden
+        // todas en dos jugadas
+        return node.refuted > 0 ? 2 : 0;
+    }
+    int best = attackerToMove ? MAX_PLY : (node.refuted > 0 ? 2 : 0);
+    for (int32_t child = node.firstChild; child < node.firstChild + node.childCount; child++) {
+        if (nodes[child].proof != 0) {
+            continue;
+        }
+        int distance = 1 + winDistance(child, !attackerToMove);
+        best = attackerToMove ? min(best, distance) : max(best, distance);
+    }
+    return best;
+}
+
+inline void ThreatSearch::extractPV(ThreatResult& result) {
+    // Desde la raíz, el atacante sigue la victoria más corta y el defensor la
+    // respuesta que más la demora
+    int32_t current = 0;
+    bool attackerToMove = true;
+    while (nodes[current].childCount > 0) {
+        const ThreatNode& node = nodes[current];
+        int32_t chosen = THREAT_NO_NODE;
+        int chosenDistance = 0;
+        for (int32_t child = node.firstChild; child < node.firstChild + node.childCount; child++) {
+            if (nodes[child].proof != 0) {
+                continue;
+            }
+            int distance = winDistance(child, !attackerToMove);
+            if (chosen == THREAT_NO_NODE || (attackerToMove ? distance < chosenDistance : distance > chosenDistance)) {
+                chosen = child;
+                chosenDistance = distance;
+            }
+        }
+        result.pv.push_back(nodes[chosen].move);
+        current = chosen;
+        attackerToMove = !attackerToMove;
+    }
+
+    // Si la línea termina en el turno del defensor, todas sus respuestas
+    // pierden enseguida: se completa con una de ellas y la jugada que gana
+    if (attackerToMove) {
+        return;
+    }
+    size_t played = result.pv.size();
+    for (const Move& move : result.pv) {
+        pos->makeMove(move);
+    }
+    if (!pos->gameOver) {
+        MoveList moves;
+        generateMoves(*pos, moves);
+        pos->makeMove(moves[0]);
+        ThreatMap threats;
+        findThreats(pos->board, threats);
+        Bitboard wins = winningSquares(*pos, threats, attacker);
+        result.pv.push_back(moves[0]);
+        result.pv.push_back(Move(popLsb(wins), PieceType::GATO));
+        pos->unmakeMove();
+    }
+    for (size_t i = 0; i < played; i++) {
+        pos->unmakeMove();
+    }
+}
+
+#endif // BOOPTHREATS_H
@@ -0,0 +1,54 @@
+#ifndef BOOPZOBRIST_H
+#define BOOPZOBRIST_H
+
+#include <cstdint>
+
+#include "BoopBitboard.h"
+
+// Claves Zobrist para identificar posiciones con un hash de 64 bits.
+// Se generan en compilación con splitmix64 y una semilla fija, así que son
+// las mismas en cada ejecución y sirven para archivos guardados en disco.
+// Hay claves para las 64 casillas, así que sirven para cualquier tamaño.
+
+// Las reservas pueden crecer con cada graduación; los valores mayores que
+// SUPPLY_KEYS - 1 comparten clave
+const int SUPPLY_KEYS = 64;
+
+struct ZobristKeys {
+    uint64_t piece[NUM_PLAYERS][NUM_PIECE_TYPES][MAX_SQUARES];
+    uint64_t supply[NUM_PLAYERS][NUM_PIECE_TYPES][SUPPLY_KEYS];
+    uint64_t side;
+};
+
+constexpr uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys makeZobristKeys() {
+    ZobristKeys keys{};
+    uint64_t state = 0x426F6F7030303030ULL;
+
+    for (int p = 0; p < NUM_PLAYERS; p++) {
+        for (int t = 0; t < NUM_PIECE_TYPES; t++) {
+            for (int sq = 0; sq < MAX_SQUARES; sq++) {
+                keys.piece[p][t][sq] = splitmix64(state);
+            }
+            for (int n = 0; n < SUPPLY_KEYS; n++) {
+                keys.supply[p][t][n] = splitmix64(state);
+            }
+        }
+    }
+    keys.side = splitmix64(state);
+    return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST = makeZobristKeys();
+
+inline uint64_t supplyKey(int player, int type, int count) {
+    return ZOBRIST.supply[player][type][count < SUPPLY_KEYS ? count : SUPPLY_KEYS - 1];
+}
+
+#endif // BOOPZOBRIST_H
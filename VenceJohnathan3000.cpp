@@ -1,25 +1,45 @@
 #include <vector>
 #include <utility>
+#include <optional>
+
+#include "VenceJohnathan3000.h"
+#include "BoopGame.h"
 
 using namespace std;
 
 
-// Forward declaration para evitar dependencia circular
-class Piece;
+// Convierte una máscara en posiciones (row, col), de arriba a abajo
+static vector<pair<int, int>> squaresToPositions(Bitboard squares) {
+    vector<pair<int, int>> positions;
+    positions.reserve(popCount(squares));
+    while (squares) {
+        int sq = popLsb(squares);
+        positions.push_back({rowOf(sq), colOf(sq)});
+    }
+    return positions;
+}
+
+vector<pair<int, int>> IsCenterAvailible(const Board& board){
+    return squaresToPositions(Board::Geometry::CENTER & board.bits.empty());
+}
 
-vector<pair<int, int>> IsCenterAvailible(vector<vector<Piece*>> Grid){
-    int center_positions[4][2]  = {{2, 2}, {2, 3}, {3, 2}, {3, 3}};
+// Las amenazas salen de los contadores de líneas del tablero: solo se
+// recorren las líneas que ya tienen dos piezas y un hueco
+PromotionThreats FindPromotionThreats(const Board& board, const Player* player) {
+    Bitboard empty = board.bits.empty();
 
-    vector<pair<int, int>> availableCenters;
+    PromotionThreats result;
+    result.gatitos = squaresToPositions(board.lines.threatSquares(player->index, typeIndex(PieceType::GATITO), empty));
+    result.gatos = squaresToPositions(board.lines.threatSquares(player->index, typeIndex(PieceType::GATO), empty));
+    return result;
+}
 
-    for (int i = 0; i < 4; i++) {
-        int row = center_positions[i][0];
-        int col = center_positions[i][1];
-        
-        if (Grid[row][col] == nullptr) {  
-            availableCenters.push_back({row, col});
-        }
+optional<pair<int, int>> CanPromote(const Board& board, const Player* player, PieceType piece_type) {
+    // Igual que la versión de Python: la primera casilla recorriendo por filas
+    Bitboard squares = board.lines.threatSquares(player->index, typeIndex(piece_type), board.bits.empty());
+    if (!squares) {
+        return nullopt;
     }
-    
-    return availableCenters;
-}
\ No newline at end of file
+    int sq = popLsb(squares);
+    return make_pair(rowOf(sq), colOf(sq));
+}
@@ -5,18 +5,32 @@
 #include <utility>
 #include <optional>
 
+#include "BoopBitboard.h"
+
 // Forward declarations
-class Piece;
+template <int N>
+class BasicBoard;
+using Board = BasicBoard<BOARD_SIZE>;
 class Player;
-enum class PieceType;
 
 // Función que verifica qué posiciones centrales están disponibles
 // Retorna un vector de pares (row, col) con las posiciones centrales vacías
-// Las posiciones centrales son: (2,2), (2,3), (3,2), (3,3)
-std::vector<std::pair<int, int>> IsCenterAvailible(std::vector<std::vector<Piece*>> Grid);
+// Las posiciones centrales son: (2,2), (2,3), (3,2), (3,3), las de BoardGeometry::CENTER
+std::vector<std::pair<int, int>> IsCenterAvailible(const Board& board);
+
+// Casillas vacías donde el jugador completaría tres en línea, por tipo de pieza.
+// Con gatitos son amenazas de graduación y con gatos son casillas ganadoras
+struct PromotionThreats {
+    std::vector<std::pair<int, int>> gatitos;
+    std::vector<std::pair<int, int>> gatos;
+};
+
+// Función que busca en una sola pasada todas las jugadas que hacen tres en línea
+// para el jugador, con ambos tipos de pieza
+PromotionThreats FindPromotionThreats(const Board& board, const Player* player);
 
 // Función que encuentra si hay una jugada que haga tres en línea
 // Retorna optional con la posición (row, col) si existe, o nullopt si no hay ninguna
-std::optional<std::pair<int, int>> CanPromote(std::vector<std::vector<Piece*>> Grid, Player* player, PieceType piece_type);
+std::optional<std::pair<int, int>> CanPromote(const Board& board, const Player* player, PieceType piece_type);
 
 #endif // VENCEJOHNATHAN3000_H